@@ -0,0 +1,143 @@
+#include "Chip8Api.h"
+
+#include "Machine.h"
+
+#include <cstring>
+#include <cstddef>
+#include <new>
+
+const int CHIP8_API_VERSION = 1;
+
+// Lives at the start of every pool. The freshly loaded machine is kept so resets are a single copy.
+struct alignas(CHIP8_POOL_ALIGNMENT) PoolHeader
+{
+    int machineCount;
+    Machine romImage;
+};
+
+// Round the stride up to the alignment so every machine starts on its own cache line
+const size_t MACHINE_STRIDE{ (sizeof(Machine) + CHIP8_POOL_ALIGNMENT - 1) & ~static_cast<size_t>(CHIP8_POOL_ALIGNMENT - 1) };
+const size_t MACHINES_OFFSET{ (sizeof(PoolHeader) + CHIP8_POOL_ALIGNMENT - 1) & ~static_cast<size_t>(CHIP8_POOL_ALIGNMENT - 1) };
+
+static inline PoolHeader* poolHeader(void* pool)
+{
+    return static_cast<PoolHeader*>(pool);
+}
+
+static inline Machine* poolMachine(void* pool, int index)
+{
+    return reinterpret_cast<Machine*>(static_cast<char*>(pool) + MACHINES_OFFSET + (index * MACHINE_STRIDE));
+}
+
+int chip8_api_version(void)
+{
+    return CHIP8_API_VERSION;
+}
+
+size_t chip8_pool_size(int machineCount)
+{
+    if (machineCount <= 0)
+    {
+        return 0;
+    }
+    return MACHINES_OFFSET + (static_cast<size_t>(machineCount) * MACHINE_STRIDE);
+}
+
+size_t chip8_machines_offset(void)
+{
+    return MACHINES_OFFSET;
+}
+
+size_t chip8_machine_stride(void)
+{
+    return MACHINE_STRIDE;
+}
+
+size_t chip8_screen_offset(void)
+{
+    return offsetof(Machine, screenRows);
+}
+
+size_t chip8_memory_offset(void)
+{
+    return offsetof(Machine, memory);
+}
+
+size_t chip8_registers_offset(void)
+{
+    return offsetof(Machine, VRegister);
+}
+
+int chip8_pool_init(void* pool, int machineCount, const uint8_t* rom, int romSize, uint32_t seed)
+{
+    if (pool == nullptr || machineCount <= 0 || (reinterpret_cast<uintptr_t>(pool) % CHIP8_POOL_ALIGNMENT) != 0)
+    {
+        return -1;
+    }
+
+    PoolHeader* header{ new (pool) PoolHeader{} };
+    header->machineCount = machineCount;
+    resetMachine(header->romImage, 0);
+    if (rom != nullptr && romSize > 0)
+    {
+        loadRomData(header->romImage, rom, romSize);
+    }
+
+    chip8_pool_reset(pool, -1, seed);
+    return 0;
+}
+
+int chip8_pool_reset(void* pool, int index, uint32_t seed)
+{
+    if (pool == nullptr)
+    {
+        return -1;
+    }
+    PoolHeader* header{ poolHeader(pool) };
+    if (index < -1 || index >= header->machineCount)
+    {
+        return -1;
+    }
+
+    int first{ (index < 0) ? 0 : index };
+    int last{ (index < 0) ? header->machineCount : index + 1 };
+
+    for (int i{ first }; i < last; i++)
+    {
+        Machine* machine{ poolMachine(pool, i) };
+        std::memcpy(static_cast<void*>(machine), &header->romImage, sizeof(Machine));
+        machine->rngState = ((seed + i) != 0) ? (seed + i) : 0x2545F491;
+    }
+    return 0;
+}
+
+void chip8_step_batch(void* pool, const uint16_t* actions, int frameCount, uint8_t* done)
+{
+    if (pool == nullptr || frameCount <= 0)
+    {
+        return;
+    }
+    int machineCount{ poolHeader(pool)->machineCount };
+
+    // machines are stepped one at a time for the whole step so each one stays hot in cache
+    for (int i{ 0 }; i < machineCount; i++)
+    {
+        Machine &machine{ *poolMachine(pool, i) };
+
+        uint16_t keys{ (actions != nullptr) ? actions[i] : uint16_t{ 0 } };
+        for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+        {
+            machine.keyPresses[key] = ((keys >> key) & 1) != 0;
+        }
+
+        for (int frame{ 0 }; frame < frameCount; frame++)
+        {
+            executeFrame(machine);
+        }
+
+        if (done != nullptr)
+        {
+            done[i] = (machine.currentInstruction >= CART_MEMORY_END) ? 1 : 0;
+        }
+    }
+}
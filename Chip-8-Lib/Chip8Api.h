@@ -0,0 +1,63 @@
+#pragma once
+
+/*
+ * C ABI for driving many CHIP-8 machines from another process or language runtime.
+ *
+ * The caller owns all memory. A pool is a single contiguous block of chip8_pool_size(N) bytes, aligned to
+ * CHIP8_POOL_ALIGNMENT, holding N machines back to back at a stride of chip8_machine_stride(). Observations are
+ * read straight out of that block, so nothing is copied between steps:
+ *
+ *   framebuffer of machine i   pool + chip8_machines_offset() + i * stride + chip8_screen_offset()
+ *                              32 rows of uint64_t (native endian), leftmost pixel in the most significant bit
+ *   memory of machine i        pool + chip8_machines_offset() + i * stride + chip8_memory_offset()
+ *                              4096 bytes, for reading scores or lives at known addresses
+ *   registers of machine i     pool + chip8_machines_offset() + i * stride + chip8_registers_offset()
+ *                              V0 through VF
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifdef CHIP8_BUILD_DLL
+#define CHIP8_API __declspec(dllexport)
+#else
+#define CHIP8_API __declspec(dllimport)
+#endif
+#else
+#define CHIP8_API __attribute__((visibility("default")))
+#endif
+
+#define CHIP8_POOL_ALIGNMENT 64
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+CHIP8_API int chip8_api_version(void);
+
+/* Bytes needed for a pool of machineCount machines, or 0 when machineCount is not positive. */
+CHIP8_API size_t chip8_pool_size(int machineCount);
+
+CHIP8_API size_t chip8_machines_offset(void);
+CHIP8_API size_t chip8_machine_stride(void);
+CHIP8_API size_t chip8_screen_offset(void);
+CHIP8_API size_t chip8_memory_offset(void);
+CHIP8_API size_t chip8_registers_offset(void);
+
+/* Lays out machineCount machines in pool, each loaded with rom. Machine i gets RNG seed (seed + i).
+   Returns 0 on success, -1 on a null or misaligned pool or an invalid count. */
+CHIP8_API int chip8_pool_init(void* pool, int machineCount, const uint8_t* rom, int romSize, uint32_t seed);
+
+/* Restores machine index (or every machine when index is -1) to the freshly loaded ROM.
+   Returns 0 on success, -1 on a null pool or an index outside the pool. */
+CHIP8_API int chip8_pool_reset(void* pool, int index, uint32_t seed);
+
+/* Advances every machine by frameCount frames in one call. actions[i] is a bitmask of the keys held on machine i
+   (bit k = key k) for the duration of the step. If done is non-null, done[i] is set to 1 for machines that have
+   run off the end of memory and 0 otherwise. Does nothing for a null pool or a frameCount below 1. */
+CHIP8_API void chip8_step_batch(void* pool, const uint16_t* actions, int frameCount, uint8_t* done);
+
+#ifdef __cplusplus
+}
+#endif
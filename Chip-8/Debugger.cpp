@@ -0,0 +1,389 @@
+#include "Debugger.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <stdexcept>
+
+// addresses are masked first, so the bit index can never be negative or past the end of the bitmap
+static inline bool testBit(const uint64_t bitmap[], int address)
+{
+    address &= 0xFFF;
+    return ((bitmap[address / 64] >> (address % 64)) & 1) != 0;
+}
+
+static inline void flipBit(uint64_t bitmap[], int address)
+{
+    address &= 0xFFF;
+    bitmap[address / 64] ^= (uint64_t{ 1 } << (address % 64));
+}
+
+void resetDebugger(Debugger &debugger)
+{
+    std::memset(debugger.breakpoints, 0, sizeof(debugger.breakpoints));
+    std::memset(debugger.watchpoints, 0, sizeof(debugger.watchpoints));
+    debugger.breakpointCount = 0;
+    debugger.watchpointCount = 0;
+    debugger.conditions.clear();
+    debugger.stepping = false;
+    debugger.quitRequested = false;
+    debugger.wasActive = false;
+    debugger.traceBeforeActive = false;
+    debugger.history.clear();
+    debugger.historyNext = 0;
+    debugger.historySize = 0;
+}
+
+bool debuggerActive(const Debugger &debugger)
+{
+    return debugger.stepping || debugger.breakpointCount != 0 || debugger.watchpointCount != 0 || !debugger.conditions.empty();
+}
+
+void updateDebuggerTrace(Machine &machine, Debugger &debugger)
+{
+    bool active{ debuggerActive(debugger) };
+    if (active == debugger.wasActive)
+    {
+        return;
+    }
+
+    if (active)
+    {
+        debugger.traceBeforeActive = machine.traceEnabled;
+        machine.traceEnabled = false;
+    }
+    else
+    {
+        machine.traceEnabled = debugger.traceBeforeActive;
+    }
+    debugger.wasActive = active;
+}
+
+void toggleBreakpoint(Debugger &debugger, int address)
+{
+    debugger.breakpointCount += testBit(debugger.breakpoints, address) ? -1 : 1;
+    flipBit(debugger.breakpoints, address);
+}
+
+void toggleWatchpoint(Debugger &debugger, int address, int length)
+{
+    for (int i{ 0 }; i < length; i++)
+    {
+        debugger.watchpointCount += testBit(debugger.watchpoints, address + i) ? -1 : 1;
+        flipBit(debugger.watchpoints, address + i);
+    }
+}
+
+// FX33 and FX55 are the only instructions that write memory; both write at I
+static bool hitsWatchpoint(const Machine &machine, const Debugger &debugger, int opcode)
+{
+    int length{ 0 };
+    if ((opcode & 0xF0FF) == 0xF033)
+    {
+        length = 3;
+    }
+    else if ((opcode & 0xF0FF) == 0xF055)
+    {
+        length = ((opcode & 0x0F00) / 0x0100) + 1;
+    }
+
+    for (int i{ 0 }; i < length; i++)
+    {
+        if (testBit(debugger.watchpoints, machine.IRegister + i))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Only fires on the instruction that makes a condition true, so continuing doesn't immediately break again
+static bool hitsCondition(const Machine &machine, const Machine &previous, const Debugger &debugger)
+{
+    for (const RegisterCondition &condition : debugger.conditions)
+    {
+        if (machine.VRegister[condition.registerIndex] == condition.value && previous.VRegister[condition.registerIndex] != condition.value)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void pushHistory(Debugger &debugger, const Machine &machine)
+{
+    // ~4.5 MB of snapshots, so a session that never breaks in never pays for them
+    if (debugger.history.empty())
+    {
+        debugger.history.resize(HISTORY_DEPTH);
+    }
+    debugger.history[debugger.historyNext] = machine;
+    debugger.historyNext = (debugger.historyNext + 1) % HISTORY_DEPTH;
+    if (debugger.historySize < HISTORY_DEPTH)
+    {
+        debugger.historySize++;
+    }
+}
+
+static bool popHistory(Debugger &debugger, Machine &machine)
+{
+    if (debugger.historySize == 0)
+    {
+        return false;
+    }
+    debugger.historyNext = (debugger.historyNext + HISTORY_DEPTH - 1) % HISTORY_DEPTH;
+    debugger.historySize--;
+    machine = debugger.history[debugger.historyNext];
+    return true;
+}
+
+// Same frame as executeFrame, with every check the debugger needs done around each instruction
+void runDebugFrame(Machine &machine, Debugger &debugger)
+{
+    tickTimers(machine);
+
+    for (int i{ 0 }; machine.currentInstruction < CART_MEMORY_END && i <= EXECUTIONS_PER_FRAME && !debugger.quitRequested; i++)
+    {
+        int pc{ machine.currentInstruction };
+        int opcode{ (machine.memory[pc] * 0x100) + machine.memory[pc + 1] };
+
+        if (debugger.stepping)
+        {
+            debuggerPrompt(machine, debugger, "step");
+        }
+        else if (testBit(debugger.breakpoints, pc))
+        {
+            debuggerPrompt(machine, debugger, "breakpoint");
+        }
+        else if (hitsWatchpoint(machine, debugger, opcode))
+        {
+            debuggerPrompt(machine, debugger, "watchpoint");
+        }
+
+        if (debugger.quitRequested)
+        {
+            break;
+        }
+
+        pushHistory(debugger, machine);
+        executeInstruction(machine);
+
+        if (hitsCondition(machine, debugger.history[(debugger.historyNext + HISTORY_DEPTH - 1) % HISTORY_DEPTH], debugger))
+        {
+            debugger.stepping = true;
+        }
+
+        if (machine.waitingForKey)
+        {
+            break;
+        }
+    }
+}
+
+static void printRegisters(const Machine &machine)
+{
+    std::cout << std::hex << std::uppercase;
+    for (int i{ 0 }; i < 16; i++)
+    {
+        std::cout << "V" << i << "=" << std::setw(2) << std::setfill('0') << static_cast<int>(machine.VRegister[i]) << ((i % 8 == 7) ? "\n" : " ");
+    }
+    std::cout << "I=" << std::setw(3) << machine.IRegister << " PC=" << std::setw(3) << machine.currentInstruction
+        << " DT=" << std::setw(2) << static_cast<int>(machine.delayTimer) << " ST=" << std::setw(2) << static_cast<int>(machine.soundTimer)
+        << " SP=" << static_cast<int>(machine.stackPointer) << "\n";
+    std::cout << std::nouppercase << std::setfill(' ');
+}
+
+// Hex address typed at the prompt; anything outside memory is rejected like any other bad argument
+static int parseAddress(const std::string &text)
+{
+    int address{ std::stoi(text, nullptr, 16) };
+    if (address < 0 || address >= MEMORY_SIZE)
+    {
+        throw std::out_of_range("address outside memory");
+    }
+    return address;
+}
+
+void debuggerPrompt(Machine &machine, Debugger &debugger, std::string reason)
+{
+    std::cout << "\n[" << reason << "]\n";
+    printDisassembly(machine, machine.currentInstruction, 1);
+
+    std::string line{};
+    for (;;)
+    {
+        std::cout << "(debug) ";
+        if (!std::getline(std::cin, line))
+        {
+            debugger.quitRequested = true;
+            return;
+        }
+
+        std::istringstream input{ line };
+        std::string command{};
+        input >> command;
+        if (command.empty())
+        {
+            continue;
+        }
+
+        try
+        {
+            if (command == "c")         // continue
+            {
+                debugger.stepping = false;
+                return;
+            }
+            else if (command == "s")    // step one instruction
+            {
+                debugger.stepping = true;
+                return;
+            }
+            else if (command == "b")    // step back one instruction
+            {
+                if (popHistory(debugger, machine))
+                {
+                    printDisassembly(machine, machine.currentInstruction, 1);
+                }
+                else
+                {
+                    std::cout << "No history to step back into\n";
+                }
+            }
+            else if (command == "r")
+            {
+                printRegisters(machine);
+            }
+            else if (command == "d")    // disassemble [address] [count]
+            {
+                std::string address{}, count{};
+                input >> address >> count;
+                printDisassembly(machine, address.empty() ? machine.currentInstruction : parseAddress(address),
+                    count.empty() ? 10 : std::stoi(count));
+            }
+            else if (command == "bp")   // toggle breakpoint at address
+            {
+                std::string address{};
+                input >> address;
+                if (!address.empty())
+                {
+                    toggleBreakpoint(debugger, parseAddress(address));
+                }
+            }
+            else if (command == "wp")   // toggle watchpoint on [address, address + length)
+            {
+                std::string address{}, length{};
+                input >> address >> length;
+                if (!address.empty())
+                {
+                    toggleWatchpoint(debugger, parseAddress(address), length.empty() ? 1 : std::stoi(length));
+                }
+            }
+            else if (command == "cond") // break when register equals value, or "cond clear"
+            {
+                std::string registerIndex{}, value{};
+                input >> registerIndex >> value;
+                if (registerIndex == "clear")
+                {
+                    debugger.conditions.clear();
+                }
+                else if (!value.empty())
+                {
+                    debugger.conditions.push_back(RegisterCondition{ std::stoi(registerIndex, nullptr, 16) & 0xF,
+                        static_cast<uint8_t>(std::stoi(value, nullptr, 16)) });
+                }
+            }
+            else if (command == "q")
+            {
+                debugger.quitRequested = true;
+                return;
+            }
+            else
+            {
+                std::cout << "c: continue  s: step  b: step back  r: registers  d [addr] [n]: disassemble\n"
+                    << "bp <addr>: toggle breakpoint  wp <addr> [len]: toggle watchpoint  cond <reg> <value> | cond clear  q: quit\n"
+                    << "(addresses and values are hex)\n";
+            }
+        }
+        catch (const std::exception &)
+        {
+            std::cout << "Invalid argument\n";
+        }
+    }
+}
+
+std::string disassembleOpcode(int opcode)
+{
+    std::ostringstream text{};
+    text << std::hex << std::uppercase;
+
+    int x{ (opcode & 0x0F00) / 0x0100 };
+    int y{ (opcode & 0x00F0) / 0x0010 };
+    int n{ opcode & 0x000F };
+    int nn{ opcode & 0x00FF };
+    int nnn{ opcode & 0x0FFF };
+
+    switch (opcode & 0xF000)
+    {
+    case 0x0000:
+        if (opcode == 0x00E0) { text << "CLS"; }
+        else if (opcode == 0x00EE) { text << "RET"; }
+        else { text << "SYS " << nnn; }
+        break;
+    case 0x1000: text << "JP " << nnn; break;
+    case 0x2000: text << "CALL " << nnn; break;
+    case 0x3000: text << "SE V" << x << ", " << nn; break;
+    case 0x4000: text << "SNE V" << x << ", " << nn; break;
+    case 0x5000: text << "SE V" << x << ", V" << y; break;
+    case 0x6000: text << "LD V" << x << ", " << nn; break;
+    case 0x7000: text << "ADD V" << x << ", " << nn; break;
+    case 0x8000:
+    {
+        static const char* const ALU_MNEMONICS[16]{ "LD", "OR", "AND", "XOR", "ADD", "SUB", "SHR", "SUBN",
+                                                    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, "SHL", nullptr };
+        if (ALU_MNEMONICS[n] != nullptr) { text << ALU_MNEMONICS[n] << " V" << x << ", V" << y; }
+        else { text << "DW " << opcode; }
+        break;
+    }
+    case 0x9000: text << "SNE V" << x << ", V" << y; break;
+    case 0xA000: text << "LD I, " << nnn; break;
+    case 0xB000: text << "JP V0, " << nnn; break;
+    case 0xC000: text << "RND V" << x << ", " << nn; break;
+    case 0xD000: text << "DRW V" << x << ", V" << y << ", " << n; break;
+    case 0xE000:
+        if (nn == 0x9E) { text << "SKP V" << x; }
+        else if (nn == 0xA1) { text << "SKNP V" << x; }
+        else { text << "DW " << opcode; }
+        break;
+    case 0xF000:
+        switch (nn)
+        {
+        case 0x07: text << "LD V" << x << ", DT"; break;
+        case 0x0A: text << "LD V" << x << ", K"; break;
+        case 0x15: text << "LD DT, V" << x; break;
+        case 0x18: text << "LD ST, V" << x; break;
+        case 0x1E: text << "ADD I, V" << x; break;
+        case 0x29: text << "LD F, V" << x; break;
+        case 0x33: text << "LD B, V" << x; break;
+        case 0x55: text << "LD [I], V" << x; break;
+        case 0x65: text << "LD V" << x << ", [I]"; break;
+        default: text << "DW " << opcode; break;
+        }
+        break;
+    }
+
+    return text.str();
+}
+
+void printDisassembly(const Machine &machine, int address, int count)
+{
+    std::cout << std::hex << std::uppercase << std::setfill('0');
+    for (int i{ 0 }; i < count && address >= 0 && address + 1 < MEMORY_SIZE; i++, address += OPCODE_LENGTH_IN_BYTES)
+    {
+        int opcode{ (machine.memory[address] * 0x100) + machine.memory[address + 1] };
+        std::cout << ((address == machine.currentInstruction) ? "> " : "  ")
+            << std::setw(3) << address << "  " << std::setw(4) << opcode << "  " << disassembleOpcode(opcode) << "\n";
+    }
+    std::cout << std::nouppercase << std::setfill(' ');
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+const int HISTORY_DEPTH = 1024;        // instructions that can be stepped back over
+
+// Break once VRegister[registerIndex] == value after an instruction executes
+struct RegisterCondition
+{
+    int registerIndex;
+    uint8_t value;
+};
+
+// Breakpoints and watchpoints are bitmaps with one bit per memory address. None of this is looked at by
+// executeFrame; the frontend only switches to runDebugFrame while debuggerActive returns true, so the
+// normal interpreter loop pays nothing for the debugger.
+struct Debugger
+{
+    uint64_t breakpoints[MEMORY_SIZE / 64];
+    uint64_t watchpoints[MEMORY_SIZE / 64];
+    int breakpointCount;
+    int watchpointCount;
+    std::vector<RegisterCondition> conditions;
+
+    bool stepping;              // break before the next instruction
+    bool quitRequested;
+
+    // the per-instruction trace is switched off while the debugger is active and put back when it goes inactive
+    bool wasActive;
+    bool traceBeforeActive;
+
+    // ring of machine snapshots taken before each instruction run under the debugger, allocated the first
+    // time the debugger actually runs an instruction
+    std::vector<Machine> history;
+    int historyNext;
+    int historySize;
+};
+
+void resetDebugger(Debugger &debugger);
+bool debuggerActive(const Debugger &debugger);
+
+// Call once per frame, before choosing between runDebugFrame and executeFrame
+void updateDebuggerTrace(Machine &machine, Debugger &debugger);
+
+void toggleBreakpoint(Debugger &debugger, int address);
+void toggleWatchpoint(Debugger &debugger, int address, int length);
+
+void runDebugFrame(Machine &machine, Debugger &debugger);
+void debuggerPrompt(Machine &machine, Debugger &debugger, std::string reason);
+
+std::string disassembleOpcode(int opcode);
+void printDisassembly(const Machine &machine, int address, int count);
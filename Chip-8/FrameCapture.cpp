@@ -0,0 +1,118 @@
+#include "FrameCapture.h"
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <functional>
+
+static void writeFrame(FrameCapture &capture, const CapturedFrame &frame, std::vector<char> &scaledRow, const std::vector<char> &chromaPlanes)
+{
+    const int scaledWidth{ DISPLAY_WIDTH * capture.scale };
+
+    capture.file << "FRAME\n";
+    for (int y{ 0 }; y < DISPLAY_HEIGHT; y++)
+    {
+        uint64_t row{ frame.screenRows[y] };
+        for (int x{ 0 }; x < DISPLAY_WIDTH; x++)
+        {
+            char luma{ static_cast<char>(((row >> (DISPLAY_WIDTH - 1 - x)) & 1) ? 235 : 16) };
+            for (int n{ 0 }; n < capture.scale; n++)
+            {
+                scaledRow[(x * capture.scale) + n] = luma;
+            }
+        }
+
+        for (int n{ 0 }; n < capture.scale; n++)
+        {
+            capture.file.write(scaledRow.data(), scaledWidth);
+        }
+    }
+    capture.file.write(chromaPlanes.data(), chromaPlanes.size());
+}
+
+static void runEncoder(FrameCapture &capture)
+{
+    const int scaledWidth{ DISPLAY_WIDTH * capture.scale };
+    const int scaledHeight{ DISPLAY_HEIGHT * capture.scale };
+
+    // the display is monochrome, so both 4:2:0 chroma planes are constant and written from one buffer
+    std::vector<char> scaledRow(scaledWidth);
+    std::vector<char> chromaPlanes(2 * ((scaledWidth + 1) / 2) * ((scaledHeight + 1) / 2), static_cast<char>(128));
+
+    capture.file << "YUV4MPEG2 W" << scaledWidth << " H" << scaledHeight << " F" << CLOCK_RATE << ":1 Ip A1:1 C420jpeg\n";
+
+    for (;;)
+    {
+        uint32_t tail{ capture.tail.load(std::memory_order_relaxed) };
+        if (tail == capture.head.load(std::memory_order_acquire))
+        {
+            // only exit once the queue has been drained after stopCapture
+            if (!capture.running.load(std::memory_order_acquire))
+            {
+                if (tail == capture.head.load(std::memory_order_acquire))
+                {
+                    break;
+                }
+                continue;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            continue;
+        }
+
+        writeFrame(capture, capture.queue[tail % CAPTURE_QUEUE_FRAMES], scaledRow, chromaPlanes);
+        capture.tail.store(tail + 1, std::memory_order_release);
+    }
+
+    capture.file.flush();
+}
+
+bool startCapture(FrameCapture &capture, std::string fileName, int scale)
+{
+    capture.file.open(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!capture.file.is_open())
+    {
+        std::cout << "ERROR: capture file '" << fileName << "' could not be opened.\n";
+        return false;
+    }
+
+    capture.scale = (scale < 1) ? 1 : scale;
+    capture.head.store(0);
+    capture.tail.store(0);
+    capture.framesDropped = 0;
+    capture.framesCaptured = 0;
+    capture.running.store(true);
+    capture.encoder = std::thread(runEncoder, std::ref(capture));
+
+    std::cout << "Recording to '" << fileName << "'.\n";
+    return true;
+}
+
+void captureFrame(FrameCapture &capture, const Machine &machine)
+{
+    uint32_t head{ capture.head.load(std::memory_order_relaxed) };
+    if (head - capture.tail.load(std::memory_order_acquire) == CAPTURE_QUEUE_FRAMES)
+    {
+        capture.framesDropped++;
+        return;
+    }
+
+    std::memcpy(capture.queue[head % CAPTURE_QUEUE_FRAMES].screenRows, machine.screenRows, sizeof(CapturedFrame));
+    capture.head.store(head + 1, std::memory_order_release);
+    capture.framesCaptured++;
+}
+
+void stopCapture(FrameCapture &capture)
+{
+    if (!capture.running.load())
+    {
+        return;
+    }
+
+    capture.running.store(false, std::memory_order_release);
+    capture.encoder.join();
+    capture.file.close();
+
+    std::cout << std::dec << "Recording stopped: " << capture.framesCaptured << " frames written, "
+        << capture.framesDropped << " frames dropped.\n";
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Must be a power of two
+const int CAPTURE_QUEUE_FRAMES = 256;
+
+struct CapturedFrame
+{
+    uint64_t screenRows[DISPLAY_HEIGHT];
+};
+
+// Records the raw packed display once per frame and encodes it to a Y4M stream on a background thread.
+// The emulator only ever copies 256 bytes into a single-producer/single-consumer ring; when the encoder
+// falls behind, frames are dropped and counted rather than blocking emulation.
+struct FrameCapture
+{
+    CapturedFrame queue[CAPTURE_QUEUE_FRAMES];
+    alignas(64) std::atomic<uint32_t> head{ 0 };      // next slot the producer writes, owned by the emulator thread
+    alignas(64) std::atomic<uint32_t> tail{ 0 };      // next slot the consumer reads, owned by the encoder thread
+    alignas(64) uint64_t framesDropped{ 0 };
+    uint64_t framesCaptured{ 0 };
+
+    std::atomic<bool> running{ false };
+    std::thread encoder;
+    std::ofstream file;
+    int scale{ 1 };
+};
+
+bool startCapture(FrameCapture &capture, std::string fileName, int scale);
+void captureFrame(FrameCapture &capture, const Machine &machine);
+void stopCapture(FrameCapture &capture);
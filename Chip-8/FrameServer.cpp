@@ -0,0 +1,532 @@
+#include "FrameServer.h"
+#include "SessionScheduler.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <random>
+#include <memory>
+#include <csignal>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+
+typedef SOCKET socket_t;
+const socket_t INVALID_SOCKET_HANDLE = INVALID_SOCKET;
+const int SEND_FLAGS = 0;
+
+static int pollSockets(pollfd* fds, size_t count, int timeout) { return WSAPoll(fds, static_cast<ULONG>(count), timeout); }
+static void closeSocket(socket_t s) { closesocket(s); }
+static bool lastCallWouldBlock() { return WSAGetLastError() == WSAEWOULDBLOCK; }
+static void setNonBlocking(socket_t s)
+{
+    u_long mode{ 1 };
+    ioctlsocket(s, FIONBIO, &mode);
+}
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+typedef int socket_t;
+const socket_t INVALID_SOCKET_HANDLE = -1;
+const int SEND_FLAGS = MSG_NOSIGNAL;
+
+static int pollSockets(pollfd* fds, size_t count, int timeout) { return poll(fds, count, timeout); }
+static void closeSocket(socket_t s) { close(s); }
+static bool lastCallWouldBlock() { return errno == EWOULDBLOCK || errno == EAGAIN; }
+static void setNonBlocking(socket_t s) { fcntl(s, F_SETFL, fcntl(s, F_GETFL, 0) | O_NONBLOCK); }
+#endif
+
+// Once this much output is queued for a slow client, new frames are skipped. Deltas are always taken against
+// the last frame actually queued, so the client catches up with a single larger delta once it drains.
+const size_t MAX_PENDING_OUTPUT = 64 * 1024;
+
+const int FRAME_HEADER_BYTES = 3;
+
+struct Session
+{
+    socket_t socket;
+    ScheduledSession* scheduled;        // owned by the scheduler
+    uint64_t framesSent;                // scheduled->framesRun when the last delta was queued
+    uint64_t sentRows[DISPLAY_HEIGHT];
+    std::vector<uint8_t> inBuffer;
+    std::vector<uint8_t> outBuffer;
+    size_t outOffset;
+    bool closed;
+};
+
+static bool socketLibraryStartup()
+{
+#ifdef _WIN32
+    WSADATA wsaData{};
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0)
+    {
+        std::cout << "ERROR: could not initialize Winsock\n";
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void socketLibraryShutdown()
+{
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void encodeFrameDelta(const uint64_t previousRows[DISPLAY_HEIGHT], const uint64_t currentRows[DISPLAY_HEIGHT], std::vector<uint8_t> &out)
+{
+    uint8_t delta[FRAME_BYTES];
+    for (int y{ 0 }; y < DISPLAY_HEIGHT; y++)
+    {
+        uint64_t rowDelta{ previousRows[y] ^ currentRows[y] };
+        for (int b{ 0 }; b < 8; b++)
+        {
+            delta[(y * 8) + b] = static_cast<uint8_t>(rowDelta >> (56 - (b * 8)));
+        }
+    }
+
+    size_t headerPosition{ out.size() };
+    out.push_back('F');
+    out.push_back(0);
+    out.push_back(0);
+
+    int position{ 0 };
+    while (position < FRAME_BYTES)
+    {
+        int zeroRun{ 0 };
+        while (position < FRAME_BYTES && delta[position] == 0 && zeroRun < 0xFF)
+        {
+            zeroRun++;
+            position++;
+        }
+
+        // trailing unchanged bytes are implied by the payload length
+        if (position == FRAME_BYTES)
+        {
+            break;
+        }
+
+        int literalCount{ 0 };
+        while (position + literalCount < FRAME_BYTES && delta[position + literalCount] != 0 && literalCount < 0xFF)
+        {
+            literalCount++;
+        }
+
+        out.push_back(static_cast<uint8_t>(zeroRun));
+        out.push_back(static_cast<uint8_t>(literalCount));
+        out.insert(out.end(), delta + position, delta + position + literalCount);
+        position += literalCount;
+    }
+
+    size_t payloadLength{ out.size() - headerPosition - FRAME_HEADER_BYTES };
+    out[headerPosition + 1] = static_cast<uint8_t>(payloadLength & 0xFF);
+    out[headerPosition + 2] = static_cast<uint8_t>(payloadLength >> 8);
+}
+
+bool decodeFrameDelta(const uint8_t* payload, int length, uint64_t screenRows[DISPLAY_HEIGHT])
+{
+    int position{ 0 };
+    int i{ 0 };
+    while (i < length)
+    {
+        if (i + 2 > length)
+        {
+            return false;
+        }
+
+        position += payload[i];
+        int literalCount{ payload[i + 1] };
+        i += 2;
+
+        if (position + literalCount > FRAME_BYTES || i + literalCount > length)
+        {
+            return false;
+        }
+
+        for (int n{ 0 }; n < literalCount; n++)
+        {
+            int byteIndex{ position + n };
+            screenRows[byteIndex / 8] ^= static_cast<uint64_t>(payload[i + n]) << (56 - ((byteIndex % 8) * 8));
+        }
+        position += literalCount;
+        i += literalCount;
+    }
+    return true;
+}
+
+// Set by Ctrl+C; the server finishes its current pass, closes every session and returns
+static volatile std::sig_atomic_t stopRequested{ 0 };
+
+static void requestStop(int)
+{
+    stopRequested = 1;
+}
+
+// Longest the server sleeps in poll, so a stop request is noticed even where Ctrl+C does not interrupt poll
+const int MAX_POLL_MILLISECONDS = 100;
+
+static void handleSessionInput(SessionScheduler &scheduler, Session &session)
+{
+    uint8_t buffer[512];
+    for (;;)
+    {
+        int received{ static_cast<int>(recv(session.socket, reinterpret_cast<char*>(buffer), sizeof(buffer), 0)) };
+        if (received > 0)
+        {
+            session.inBuffer.insert(session.inBuffer.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received == 0 || !lastCallWouldBlock())
+        {
+            session.closed = true;
+        }
+        break;
+    }
+
+    // key events are fixed two byte messages
+    size_t i{ 0 };
+    for (; i + 2 <= session.inBuffer.size(); i += 2)
+    {
+        uint8_t type{ session.inBuffer[i] };
+        uint8_t key{ session.inBuffer[i + 1] };
+        if (key >= NUMBER_OF_KEYS || (type != 'D' && type != 'U'))
+        {
+            std::cout << "ERROR: malformed key event, dropping session\n";
+            session.closed = true;
+            break;
+        }
+        // goes through the scheduler so a press wakes a session parked on FX0A
+        pressKey(scheduler, *session.scheduled, key, type == 'D');
+    }
+    session.inBuffer.erase(session.inBuffer.begin(), session.inBuffer.begin() + i);
+}
+
+static void flushSessionOutput(Session &session)
+{
+    while (session.outOffset < session.outBuffer.size())
+    {
+        int sent{ static_cast<int>(send(session.socket, reinterpret_cast<const char*>(session.outBuffer.data() + session.outOffset),
+            static_cast<int>(session.outBuffer.size() - session.outOffset), SEND_FLAGS)) };
+        if (sent > 0)
+        {
+            session.outOffset += sent;
+            continue;
+        }
+        if (sent < 0 && !lastCallWouldBlock())
+        {
+            session.closed = true;
+        }
+        break;
+    }
+
+    if (session.outOffset == session.outBuffer.size())
+    {
+        session.outBuffer.clear();
+        session.outOffset = 0;
+    }
+}
+
+int runFrameServer(std::string romName, int port, int maxSessions)
+{
+    // every session starts as a copy of this one
+    Machine romImage{};
+    resetMachine(romImage, 0);
+    if (loadRom(romImage, romName) == -1)
+    {
+        std::cout << "ERROR: could not load game cart\n";
+        return 0;
+    }
+
+    if (!socketLibraryStartup())
+    {
+        return 0;
+    }
+
+    socket_t listenSocket{ socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) };
+    int reuse{ 1 };
+    setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (listenSocket == INVALID_SOCKET_HANDLE
+        || bind(listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(listenSocket, SOMAXCONN) != 0)
+    {
+        std::cout << "ERROR: could not listen on port " << port << "\n";
+        socketLibraryShutdown();
+        return 0;
+    }
+    setNonBlocking(listenSocket);
+
+    std::cout << "Serving '" << romName << "' on 127.0.0.1:" << std::dec << port << " for up to " << maxSessions << " sessions.\n";
+
+    std::vector<Session> sessions{};
+    sessions.reserve(maxSessions);
+    std::vector<pollfd> pollList{};
+    std::mt19937 seeder{ std::random_device{}() };
+
+    // every session runs as a coroutine on the scheduler, paced from its own connect time; one waiting on FX0A
+    // is parked and costs nothing until a key arrives. Scheduler ticks are milliseconds since serverStart.
+    std::unique_ptr<SessionScheduler> scheduler{ std::make_unique<SessionScheduler>() };
+    const auto serverStart{ std::chrono::steady_clock::now() };
+    auto nextReport{ std::chrono::steady_clock::now() + std::chrono::seconds(5) };
+    uint64_t bytesQueued{ 0 };
+    uint64_t framesQueued{ 0 };
+    uint64_t framesSkipped{ 0 };
+
+    stopRequested = 0;
+    std::signal(SIGINT, requestStop);
+
+    while (stopRequested == 0)
+    {
+        pollList.clear();
+        pollList.push_back(pollfd{ listenSocket, POLLIN, 0 });
+        for (Session &session : sessions)
+        {
+            short events{ POLLIN };
+            if (session.outOffset < session.outBuffer.size())
+            {
+                events |= POLLOUT;
+            }
+            pollList.push_back(pollfd{ session.socket, events, 0 });
+        }
+
+        auto now{ std::chrono::steady_clock::now() };
+        auto nextFrame{ serverStart + std::chrono::milliseconds(nextDueTick(*scheduler)) };
+        // rounded up: truncating would spin with a zero timeout through the last millisecond before every tick
+        int timeout{ (now < nextFrame) ? static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(nextFrame - now).count()) : 0 };
+        if (timeout > MAX_POLL_MILLISECONDS)
+        {
+            timeout = MAX_POLL_MILLISECONDS;
+        }
+        pollSockets(pollList.data(), pollList.size(), timeout);
+
+        if (pollList[0].revents & POLLIN)
+        {
+            for (;;)
+            {
+                socket_t client{ accept(listenSocket, nullptr, nullptr) };
+                if (client == INVALID_SOCKET_HANDLE)
+                {
+                    break;
+                }
+                if (static_cast<int>(sessions.size()) >= maxSessions)
+                {
+                    closeSocket(client);
+                    continue;
+                }
+
+                setNonBlocking(client);
+                int noDelay{ 1 };
+                setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+                sessions.emplace_back();
+                Session &session{ sessions.back() };
+                Machine seeded{ romImage };
+                seeded.rngState = seeder() | 1;
+                session.socket = client;
+                session.scheduled = addSession(*scheduler, seeded, scheduler->currentTick * 1000);
+                session.framesSent = 0;
+                std::memset(session.sentRows, 0, sizeof(session.sentRows));
+                session.outOffset = 0;
+                session.closed = false;
+            }
+        }
+
+        for (size_t i{ 0 }; i < sessions.size(); i++)
+        {
+            short revents{ (i + 1 < pollList.size()) ? pollList[i + 1].revents : short{ 0 } };
+            if (revents & (POLLIN | POLLHUP | POLLERR))
+            {
+                handleSessionInput(*scheduler, sessions[i]);
+            }
+            if (revents & POLLOUT)
+            {
+                flushSessionOutput(sessions[i]);
+            }
+        }
+
+        uint64_t tick{ static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - serverStart).count()) };
+        if (tick >= scheduler->currentTick && advanceScheduler(*scheduler, tick) != 0)
+        {
+            // each session that ran a frame gets at most a single send for the tick
+            for (Session &session : sessions)
+            {
+                Machine &machine{ session.scheduled->machine };
+                if (session.scheduled->framesRun == session.framesSent)
+                {
+                    continue;
+                }
+                session.framesSent = session.scheduled->framesRun;
+
+                if (session.outBuffer.size() - session.outOffset > MAX_PENDING_OUTPUT)
+                {
+                    framesSkipped++;
+                    continue;
+                }
+
+                size_t before{ session.outBuffer.size() };
+                encodeFrameDelta(session.sentRows, machine.screenRows, session.outBuffer);
+                std::memcpy(session.sentRows, machine.screenRows, sizeof(session.sentRows));
+                machine.screenDirty = false;
+                bytesQueued += session.outBuffer.size() - before;
+                framesQueued++;
+                flushSessionOutput(session);
+            }
+        }
+
+        for (size_t i{ 0 }; i < sessions.size();)
+        {
+            if (sessions[i].closed)
+            {
+                closeSocket(sessions[i].socket);
+                removeSession(*scheduler, sessions[i].scheduled);
+                if (i + 1 != sessions.size())
+                {
+                    sessions[i] = std::move(sessions.back());
+                }
+                sessions.pop_back();
+            }
+            else
+            {
+                i++;
+            }
+        }
+
+        if (std::chrono::steady_clock::now() >= nextReport)
+        {
+            nextReport += std::chrono::seconds(5);
+            int parkedSessions{ 0 };
+            for (const Session &session : sessions)
+            {
+                parkedSessions += session.scheduled->waitingForKey ? 1 : 0;
+            }
+            std::cout << std::dec << sessions.size() << " sessions (" << parkedSessions << " waiting for a key), " << framesQueued << " frames sent, "
+                << ((framesQueued != 0) ? static_cast<double>(bytesQueued) / framesQueued : 0.0) << " bytes/frame, "
+                << framesSkipped << " frames skipped for slow clients\n";
+            bytesQueued = 0;
+            framesQueued = 0;
+            framesSkipped = 0;
+        }
+    }
+
+    std::signal(SIGINT, SIG_DFL);
+    std::cout << "Stopping server, closing " << std::dec << sessions.size() << " sessions.\n";
+    for (Session &session : sessions)
+    {
+        closeSocket(session.socket);
+    }
+    sessions.clear();
+    destroyScheduler(*scheduler);
+    closeSocket(listenSocket);
+    socketLibraryShutdown();
+    return 0;
+}
+
+int runLoopbackClient(int port, int frames, std::string heldKeys)
+{
+    if (!socketLibraryStartup())
+    {
+        return 0;
+    }
+
+    socket_t server{ socket(AF_INET, SOCK_STREAM, IPPROTO_TCP) };
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (server == INVALID_SOCKET_HANDLE || connect(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        std::cout << "ERROR: could not connect to 127.0.0.1:" << port << "\n";
+        socketLibraryShutdown();
+        return 0;
+    }
+
+    // held keys are given as hex digits, e.g. "5" or "46"
+    std::vector<uint8_t> keyEvents{};
+    for (char c : heldKeys)
+    {
+        int key{ std::stoi(std::string(1, c), nullptr, 16) };
+        keyEvents.push_back('D');
+        keyEvents.push_back(static_cast<uint8_t>(key));
+    }
+    if (!keyEvents.empty())
+    {
+        send(server, reinterpret_cast<const char*>(keyEvents.data()), static_cast<int>(keyEvents.size()), SEND_FLAGS);
+    }
+
+    uint64_t screenRows[DISPLAY_HEIGHT]{ 0 };
+    std::vector<uint8_t> inBuffer{};
+    uint8_t buffer[4096];
+    int framesReceived{ 0 };
+    uint64_t bytesReceived{ 0 };
+
+    while (framesReceived < frames)
+    {
+        int received{ static_cast<int>(recv(server, reinterpret_cast<char*>(buffer), sizeof(buffer), 0)) };
+        if (received <= 0)
+        {
+            std::cout << "ERROR: server closed the connection\n";
+            break;
+        }
+        bytesReceived += received;
+        inBuffer.insert(inBuffer.end(), buffer, buffer + received);
+
+        size_t i{ 0 };
+        while (framesReceived < frames && i + FRAME_HEADER_BYTES <= inBuffer.size())
+        {
+            if (inBuffer[i] != 'F')
+            {
+                std::cout << "ERROR: unknown message tag from server\n";
+                frames = framesReceived;
+                break;
+            }
+            int payloadLength{ inBuffer[i + 1] | (inBuffer[i + 2] << 8) };
+            if (i + FRAME_HEADER_BYTES + payloadLength > inBuffer.size())
+            {
+                break;
+            }
+            if (!decodeFrameDelta(inBuffer.data() + i + FRAME_HEADER_BYTES, payloadLength, screenRows))
+            {
+                std::cout << "ERROR: malformed frame delta\n";
+                frames = framesReceived;
+                break;
+            }
+            i += FRAME_HEADER_BYTES + payloadLength;
+            framesReceived++;
+        }
+        inBuffer.erase(inBuffer.begin(), inBuffer.begin() + i);
+    }
+
+    for (size_t i{ 0 }; i < keyEvents.size(); i += 2)
+    {
+        keyEvents[i] = 'U';
+    }
+    if (!keyEvents.empty())
+    {
+        send(server, reinterpret_cast<const char*>(keyEvents.data()), static_cast<int>(keyEvents.size()), SEND_FLAGS);
+    }
+
+    printScreenArray(screenRows);
+    std::cout << std::dec << framesReceived << " frames received, "
+        << ((framesReceived != 0) ? static_cast<double>(bytesReceived) / framesReceived : 0.0) << " bytes/frame\n";
+
+    closeSocket(server);
+    socketLibraryShutdown();
+    return 0;
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Wire protocol (all multi-byte values little-endian):
+//   server -> client  'F' <uint16 length> <payload>   XOR delta of the packed display against the last frame sent
+//   client -> server  'D' <key>  /  'U' <key>          key 0x0-0xF pressed / released
+//
+// The delta payload covers the 32 packed rows as 256 bytes, stored as a sequence of
+// <zero run length> <literal count> <literal bytes...> pairs, so an unchanged row costs nothing.
+const int FRAME_BYTES = DISPLAY_HEIGHT * 8;
+const int DEFAULT_SERVER_PORT = 6464;
+
+void encodeFrameDelta(const uint64_t previousRows[DISPLAY_HEIGHT], const uint64_t currentRows[DISPLAY_HEIGHT], std::vector<uint8_t> &out);
+bool decodeFrameDelta(const uint8_t* payload, int length, uint64_t screenRows[DISPLAY_HEIGHT]);
+
+int runFrameServer(std::string romName, int port, int maxSessions);
+int runLoopbackClient(int port, int frames, std::string heldKeys);
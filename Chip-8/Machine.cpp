@@ -0,0 +1,678 @@
+#include "Machine.h"
+
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <random>
+
+// Preloading CHIP-8 memory with onboard sprites 0 through F:
+static const uint8_t FONT_SPRITES[]{           0xF0, 0x90, 0x90, 0x90, 0xF0,     // 0
+                                               0x20, 0x60, 0x20, 0x20, 0x70,     // 1
+                                               0xF0, 0x10, 0xF0, 0x80, 0xF0,     // 2
+                                               0xF0, 0x10, 0xF0, 0x10, 0xF0,     // 3
+                                               0x90, 0x90, 0xF0, 0x10, 0x10,     // 4
+                                               0xF0, 0x80, 0xF0, 0x10, 0xF0,     // 5
+                                               0xF0, 0x80, 0xF0, 0x90, 0xF0,     // 6
+                                               0xF0, 0x10, 0x20, 0x40, 0x40,     // 7
+                                               0xF0, 0x90, 0xF0, 0x90, 0xF0,     // 8
+                                               0xF0, 0x90, 0xF0, 0x10, 0xF0,     // 9
+                                               0xF0, 0x90, 0xF0, 0x90, 0x90,     // A
+                                               0xE0, 0x90, 0xE0, 0x90, 0xE0,     // B
+                                               0xF0, 0x80, 0x80, 0x80, 0xF0,     // C
+                                               0xE0, 0x90, 0x90, 0x90, 0xE0,     // D
+                                               0xF0, 0x80, 0xF0, 0x80, 0xF0,     // E
+                                               0xF0, 0x80, 0xF0, 0x80, 0x80 };   // F
+
+const int FONT_SPRITE_SIZE{ 5 };
+
+// splitmix64 finalizer
+uint64_t mixHash(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ull;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Contribution of one byte of memory or one display row to the running hashes. Zero contributes nothing,
+// so cleared memory and a blank screen both hash to 0.
+static inline uint64_t memoryHashTerm(int address, uint8_t value)
+{
+    return (value != 0) ? mixHash((static_cast<uint64_t>(address) << 8) | value) : 0;
+}
+
+static inline uint64_t screenHashTerm(int row, uint64_t value)
+{
+    return (value != 0) ? mixHash(value + ((static_cast<uint64_t>(row) + 1) * 0x9E3779B97F4A7C15ull)) : 0;
+}
+
+static uint64_t computeMemoryHash(const Machine &machine)
+{
+    uint64_t hash{ 0 };
+    for (int address{ 0 }; address < MEMORY_SIZE; address++)
+    {
+        hash ^= memoryHashTerm(address, machine.memory[address]);
+    }
+    return hash;
+}
+
+static inline void writeMemory(Machine &machine, int address, uint8_t value)
+{
+    address &= 0xFFF;
+    machine.memoryHash ^= memoryHashTerm(address, machine.memory[address]) ^ memoryHashTerm(address, value);
+    machine.memory[address] = value;
+}
+
+uint64_t machineStateHash(const Machine &machine)
+{
+    uint64_t registers[2];
+    uint64_t stack[STACK_DEPTH / 4];
+    std::memcpy(registers, machine.VRegister, sizeof(registers));
+    std::memcpy(stack, machine.stack, sizeof(stack));
+
+    uint64_t hash{ machine.memoryHash ^ (machine.screenHash * 0x9E3779B97F4A7C15ull) };
+    hash = mixHash(hash ^ registers[0]);
+    hash = mixHash(hash ^ registers[1]);
+    for (uint64_t words : stack)
+    {
+        hash = mixHash(hash ^ words);
+    }
+    hash = mixHash(hash ^ (static_cast<uint64_t>(machine.IRegister) | (static_cast<uint64_t>(machine.currentInstruction) << 16)
+        | (static_cast<uint64_t>(machine.stackPointer) << 32) | (static_cast<uint64_t>(machine.delayTimer) << 40)
+        | (static_cast<uint64_t>(machine.soundTimer) << 48) | (static_cast<uint64_t>(machine.waitingForKey) << 56)));
+    hash = mixHash(hash ^ machine.rngState);
+    return hash;
+}
+
+char* openRomFile(int &romSize, std::string fileName)
+{
+    std::ifstream file{};
+    file.open(fileName, std::ios::in | std::ios::binary | std::ios::ate);
+
+    if (!file.is_open())
+    {
+        std::cout << "ERROR: ROM file '" << fileName << "' could not be opened.\n";
+        romSize = -1;
+        return {};
+    }
+
+    std::streampos size{ file.tellg() };
+    romSize = size;
+    char* memoryBlock{ new char[size] };
+    file.seekg(0, std::ios::beg);
+    file.read(memoryBlock, size);
+    file.close();
+
+    std::cout << "ROM file loaded.\n";
+
+    return memoryBlock;
+}
+
+void resetMachine(Machine &machine, uint32_t seed)
+{
+    std::memset(&machine, 0, sizeof(Machine));
+    std::memcpy(machine.memory, FONT_SPRITES, sizeof(FONT_SPRITES));
+    machine.currentInstruction = CART_MEMORY_START;
+    machine.memoryHash = computeMemoryHash(machine);
+
+    // xorshift32 must never be seeded with 0
+    machine.rngState = (seed != 0) ? seed : 0x2545F491;
+}
+
+void loadRomData(Machine &machine, const uint8_t* data, int size)
+{
+    int cartSpace{ MEMORY_SIZE - CART_MEMORY_START };
+    std::memcpy(machine.memory + CART_MEMORY_START, data, (size < cartSpace) ? size : cartSpace);
+    machine.memoryHash = computeMemoryHash(machine);
+}
+
+int loadRom(Machine &machine, std::string fileName)
+{
+    int romSize{};
+    char* memoryBlock{ openRomFile(romSize, fileName) };
+    if (romSize == -1)      // invalid rom size
+    {
+        return -1;
+    }
+
+    if (romSize > MEMORY_SIZE - CART_MEMORY_START)
+    {
+        std::cout << "WARNING: ROM is larger than cart memory and will be truncated.\n";
+    }
+
+    loadRomData(machine, reinterpret_cast<uint8_t*>(memoryBlock), romSize);
+    delete[] memoryBlock;
+    return romSize;
+}
+
+void printScreenArray(const uint64_t screenRows[DISPLAY_HEIGHT])
+{
+    for (int y{ 0 }; y < DISPLAY_HEIGHT; y++)
+    {
+        for (int x{ 0 }; x < DISPLAY_WIDTH; x++)
+        {
+            if ((screenRows[y] >> (DISPLAY_WIDTH - 1 - x)) & 1)
+            {
+                std::cout << "1";
+            }
+            else
+            {
+                std::cout << "0";
+            }
+        }
+        std::cout << "\n";
+    }
+}
+
+bool isPixelSet(const Machine &machine, int x, int y)
+{
+    return ((machine.screenRows[y] >> (DISPLAY_WIDTH - 1 - x)) & 1) != 0;
+}
+
+void printOpcode(int opcode, std::string text)
+{
+    std::cout << std::hex << opcode << "\t" << text;
+    return;
+}
+
+static inline void traceOpcode(const Machine &machine, int opcode, const char* text)
+{
+    if (machine.traceEnabled)
+    {
+        printOpcode(opcode, text);
+    }
+}
+
+static inline uint8_t nextRandomByte(Machine &machine)
+{
+    uint32_t x{ machine.rngState };
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    machine.rngState = x;
+    return static_cast<uint8_t>(x >> 24);
+}
+
+// XORs an n-byte sprite from memory at I onto the display, wrapping at the edges. Returns true on collision.
+static bool drawSprite(Machine &machine, int xStart, int yStart, int spriteSize)
+{
+    bool collision{ false };
+    int shift{ xStart % DISPLAY_WIDTH };
+
+    for (int spriteByte{ 0 }; spriteByte < spriteSize; spriteByte++)
+    {
+        uint64_t spriteRow{ static_cast<uint64_t>(machine.memory[(machine.IRegister + spriteByte) & 0xFFF]) << 56 };
+
+        // rotating (instead of shifting) wraps pixels past the right edge back around to the left
+        if (shift != 0)
+        {
+            spriteRow = (spriteRow >> shift) | (spriteRow << (DISPLAY_WIDTH - shift));
+        }
+
+        int y{ (yStart + spriteByte) % DISPLAY_HEIGHT };
+        uint64_t &screenRow{ machine.screenRows[y] };
+        if ((screenRow & spriteRow) != 0)
+        {
+            collision = true;
+        }
+        machine.screenHash ^= screenHashTerm(y, screenRow) ^ screenHashTerm(y, screenRow ^ spriteRow);
+        screenRow ^= spriteRow;
+    }
+
+    machine.screenDirty = true;
+    return collision;
+}
+
+void executeInstruction(Machine &machine)
+{
+    uint8_t* memory{ machine.memory };
+    uint8_t* VRegister{ machine.VRegister };
+
+    int currentOpcode{ (memory[machine.currentInstruction & 0xFFF] * 0x100) + memory[(machine.currentInstruction + 1) & 0xFFF] };
+
+    if (machine.traceEnabled)
+    {
+        std::cout << machine.currentInstruction << "\t";
+    }
+
+    machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+
+    switch (currentOpcode & 0xF000) // checking first bit
+    {
+    case 0x0000:
+    {
+        switch (currentOpcode)
+        {
+        case 0x00E0:    // CLS
+        {
+            std::memset(machine.screenRows, 0, sizeof(machine.screenRows));
+            machine.screenHash = 0;
+            machine.screenDirty = true;
+            traceOpcode(machine, currentOpcode, "Clearing screen");
+            break;
+        }
+        case 0x00EE:    // RET
+        {
+            if (machine.stackPointer == 0)
+            {
+                // only reported while tracing: headless hosts run untrusted ROMs, and this would repeat every instruction
+                if (machine.traceEnabled)
+                {
+                    std::cout << "ERROR: stack pointer access failure\n";
+                }
+            }
+            else
+            {
+                machine.stackPointer--;
+                machine.currentInstruction = machine.stack[machine.stackPointer];
+            }
+            traceOpcode(machine, currentOpcode, "Returning from subroutine");
+            break;
+        }
+        default:        // Invalid opcode
+        {
+            traceOpcode(machine, currentOpcode, "Unknown opcode");
+            break;
+        }
+        }
+        break;
+    }
+
+    case 0x1000:    // JP nnn
+    {
+        machine.currentInstruction = currentOpcode & 0x0FFF;
+        traceOpcode(machine, currentOpcode, "Jumping to address");
+        break;
+    }
+    case 0x2000:    // CALL nnn
+    {
+        if (machine.stackPointer == STACK_DEPTH)
+        {
+            if (machine.traceEnabled)
+            {
+                std::cout << "ERROR: stack overflow\n";
+            }
+        }
+        else
+        {
+            machine.stack[machine.stackPointer] = machine.currentInstruction;
+            machine.stackPointer++;
+            machine.currentInstruction = currentOpcode & 0x0FFF;
+        }
+        traceOpcode(machine, currentOpcode, "Calling subroutine");
+        break;
+    }
+    case 0x3000:    // SE Vx, nn
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        int value{ currentOpcode & 0x00FF };
+        if (VRegister[Vx] == value)
+        {
+            machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+            traceOpcode(machine, currentOpcode, "Skipping next instruction");
+        }
+        else
+        {
+            traceOpcode(machine, currentOpcode, "Not skipping next instruction");
+        }
+        break;
+    }
+    case 0x4000:    // SNE Vx, nn
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        int value{ currentOpcode & 0x00FF };
+        if (VRegister[Vx] != value)
+        {
+            machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+            traceOpcode(machine, currentOpcode, "Skipping next instruction");
+        }
+        else
+        {
+            traceOpcode(machine, currentOpcode, "Not skipping next instruction");
+        }
+        break;
+    }
+    case 0x5000:    // SE Vx, Vy
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        int Vy{ (currentOpcode & 0x00F0) / 0x0010 };
+        if (VRegister[Vx] == VRegister[Vy])
+        {
+            machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+            traceOpcode(machine, currentOpcode, "Skipping next instruction");
+        }
+        else
+        {
+            traceOpcode(machine, currentOpcode, "Not skipping next instruction");
+        }
+        break;
+    }
+    case 0x6000:    // LD Vx, nn
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        VRegister[Vx] = currentOpcode & 0x00FF;
+        traceOpcode(machine, currentOpcode, "Putting value into register");
+        break;
+    }
+    case 0x7000:    // ADD Vx, nn
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        VRegister[Vx] += currentOpcode & 0x00FF;
+        traceOpcode(machine, currentOpcode, "Adding value to register");
+        break;
+    }
+    case 0x8000:
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        int Vy{ (currentOpcode & 0x00F0) / 0x0010 };
+
+        switch (currentOpcode & 0x000F)
+        {
+        case 0x0000:    // LD Vx, Vy
+        {
+            VRegister[Vx] = VRegister[Vy];
+            traceOpcode(machine, currentOpcode, "Storing value from register Vy to Vx");
+            break;
+        }
+        case 0x0001:    // OR Vx, Vy
+        {
+            VRegister[Vx] = (VRegister[Vx] | VRegister[Vy]);
+            VRegister[0xF] = 0;
+            traceOpcode(machine, currentOpcode, "Computing bitwise OR on Vx and Vy");
+            break;
+        }
+        case 0x0002:    // AND Vx, Vy
+        {
+            VRegister[Vx] = (VRegister[Vx] & VRegister[Vy]);
+            VRegister[0xF] = 0;
+            traceOpcode(machine, currentOpcode, "Computing bitwise AND on Vx and Vy");
+            break;
+        }
+        case 0x0003:    // XOR Vx, Vy
+        {
+            VRegister[Vx] = (VRegister[Vx] ^ VRegister[Vy]);
+            VRegister[0xF] = 0;
+            traceOpcode(machine, currentOpcode, "Computing bitwise XOR on Vx and Vy");
+            break;
+        }
+        case 0x0004:    // ADD Vx, Vy
+        {
+            int sum{ VRegister[Vx] + VRegister[Vy] };
+            VRegister[Vx] = sum;
+            VRegister[0xF] = (sum > 0xFF) ? 0x01 : 0x00;
+            traceOpcode(machine, currentOpcode, "Adding register Vx and Vy");
+            break;
+        }
+        case 0x0005:    // SUB Vx, Vy
+        {
+            uint8_t notBorrow{ (VRegister[Vx] >= VRegister[Vy]) ? uint8_t{ 0x01 } : uint8_t{ 0x00 } };
+            VRegister[Vx] -= VRegister[Vy];
+            VRegister[0xF] = notBorrow;
+            traceOpcode(machine, currentOpcode, "Subtracting Vy from Vx");
+            break;
+        }
+        case 0x0006:    // SHR Vx
+        {
+            VRegister[Vx] = VRegister[Vy];
+            uint8_t shift{ static_cast<uint8_t>(VRegister[Vx] & 0b00000001) };
+            VRegister[Vx] >>= 1;
+            VRegister[0xF] = shift;
+            traceOpcode(machine, currentOpcode, "Dividing register Vx by 2");
+            break;
+        }
+        case 0x0007:    // SUBN Vx, Vy
+        {
+            uint8_t notBorrow{ (VRegister[Vy] >= VRegister[Vx]) ? uint8_t{ 0x01 } : uint8_t{ 0x00 } };
+            VRegister[Vx] = (VRegister[Vy] - VRegister[Vx]);
+            VRegister[0xF] = notBorrow;
+            traceOpcode(machine, currentOpcode, "Setting register Vx to Vy - Vx");
+            break;
+        }
+        case 0x000E:    // SHL Vx
+        {
+            VRegister[Vx] = VRegister[Vy];
+            uint8_t shift{ static_cast<uint8_t>((VRegister[Vx] & 0b10000000) / 128) };
+            VRegister[Vx] <<= 1;
+            VRegister[0xF] = shift;
+            traceOpcode(machine, currentOpcode, "Doubling register Vx");
+            break;
+        }
+        default:        // Invalid opcode
+        {
+            traceOpcode(machine, currentOpcode, "Unknown opcode");
+            break;
+        }
+        }
+        break;
+    }
+    case 0x9000:
+    {
+        switch (currentOpcode & 0x000F)
+        {
+        case 0x0000:    // SNE Vx, VY
+        {
+            int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+            int Vy{ (currentOpcode & 0x00F0) / 0x0010 };
+            if (VRegister[Vx] != VRegister[Vy])
+            {
+                machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+                traceOpcode(machine, currentOpcode, "Skipping next instruction");
+            }
+            else
+            {
+                traceOpcode(machine, currentOpcode, "Not skipping next instruction");
+            }
+            break;
+        }
+        default:
+        {
+            traceOpcode(machine, currentOpcode, "Unknown opcode");
+            break;
+        }
+        }
+        break;
+    }
+    case 0xA000:    // LD I, nnn
+    {
+        machine.IRegister = currentOpcode & 0x0FFF;
+        traceOpcode(machine, currentOpcode, "Loading value to register I");
+        break;
+    }
+    case 0xB000:    // JP V0, nnn
+    {
+        machine.currentInstruction = (currentOpcode & 0x0FFF) + VRegister[0];
+        traceOpcode(machine, currentOpcode, "Jumping to address plus V0");
+        break;
+    }
+    case 0xC000:    // RND Vx, nn
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        VRegister[Vx] = nextRandomByte(machine) & (currentOpcode & 0x00FF);
+        traceOpcode(machine, currentOpcode, "Storing random number to register Vx");
+        break;
+    }
+    case 0xD000:    // DRW Vx, Vy, n
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+        int Vy{ (currentOpcode & 0x00F0) / 0x0010 };
+
+        // if collision is detected, set register F to 1
+        VRegister[0xF] = drawSprite(machine, VRegister[Vx], VRegister[Vy], currentOpcode & 0x000F) ? 0x1 : 0x0;
+
+        traceOpcode(machine, currentOpcode, "Drawing sprite to screen");
+        break;
+    }
+    case 0xE000:
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+
+        switch (currentOpcode & 0x00FF)
+        {
+        case 0x009E:    // SKP Vx
+        {
+            if (machine.keyPresses[VRegister[Vx] & 0xF] == true)
+            {
+                machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+                traceOpcode(machine, currentOpcode, "Skipping next instruction since value is pressed");
+            }
+            else
+            {
+                traceOpcode(machine, currentOpcode, "Not skipping next instruction since value is not pressed");
+            }
+            break;
+        }
+        case 0x00A1:    // SKNP Vx
+        {
+            if (machine.keyPresses[VRegister[Vx] & 0xF] != true)
+            {
+                machine.currentInstruction += OPCODE_LENGTH_IN_BYTES;
+                traceOpcode(machine, currentOpcode, "Skipping next instruction since value is not pressed");
+            }
+            else
+            {
+                traceOpcode(machine, currentOpcode, "Not skipping next instruction since value is pressed");
+            }
+            break;
+        }
+        default:
+        {
+            traceOpcode(machine, currentOpcode, "Unknown opcode");
+            break;
+        }
+        }
+        break;
+    }
+    case 0xF000:
+    {
+        int Vx{ (currentOpcode & 0x0F00) / 0x0100 };
+
+        switch (currentOpcode & 0x00FF)
+        {
+        case 0x0007:    // LD Vx, DT
+        {
+            VRegister[Vx] = machine.delayTimer;
+            traceOpcode(machine, currentOpcode, "Placing value of DT into Vx");
+            break;
+        }
+        case 0x000A:    // LD Vx, K
+        {
+            machine.waitingForKey = true;
+            for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+            {
+                if (machine.keyPresses[key])
+                {
+                    VRegister[Vx] = key;
+                    machine.waitingForKey = false;
+                    break;
+                }
+            }
+
+            // no key is down yet, so this instruction is re-executed on the next frame
+            if (machine.waitingForKey)
+            {
+                machine.currentInstruction -= OPCODE_LENGTH_IN_BYTES;
+            }
+            traceOpcode(machine, currentOpcode, "Waiting for key press, putting it into register Vx");
+            break;
+        }
+        case 0x0015:    // LD DT, Vx
+        {
+            machine.delayTimer = VRegister[Vx];
+            traceOpcode(machine, currentOpcode, "Setting DT to register Vx");
+            break;
+        }
+        case 0x0018:    // LD ST, Vx
+        {
+            machine.soundTimer = VRegister[Vx];
+            traceOpcode(machine, currentOpcode, "Setting ST to register Vx");
+            break;
+        }
+        case 0x001E:    // ADD I, Vx
+        {
+            machine.IRegister = (machine.IRegister + VRegister[Vx]) & 0xFFFF;
+            traceOpcode(machine, currentOpcode, "Adding register Vx to register I");
+            break;
+        }
+        case 0x0029:    // LD F, Vx
+        {
+            machine.IRegister = (VRegister[Vx] & 0xF) * FONT_SPRITE_SIZE;
+            traceOpcode(machine, currentOpcode, "Setting register I to location of sprite at Vx");
+            break;
+        }
+        case 0x0033:    // LD B, Vx
+        {
+            writeMemory(machine, machine.IRegister, (VRegister[Vx] / 100) % 10);
+            writeMemory(machine, machine.IRegister + 0x0001, (VRegister[Vx] / 10) % 10);
+            writeMemory(machine, machine.IRegister + 0x0002, (VRegister[Vx]) % 10);
+            traceOpcode(machine, currentOpcode, "Storing binary of Vx at I, I+1, and I+2");
+            break;
+        }
+        case 0x0055:    // LD [I]. Vx
+        {
+            for (int i{ 0 }; i <= Vx; i++)
+            {
+                writeMemory(machine, machine.IRegister, VRegister[i]);
+                machine.IRegister++;
+            }
+            traceOpcode(machine, currentOpcode, "Storing registers V0 through Vx at memory location I");
+            break;
+        }
+        case 0x0065:    // LD Vx, [I]
+        {
+            for (int i{ 0 }; i <= Vx; i++)
+            {
+                VRegister[i] = memory[(machine.IRegister) & 0xFFF];
+                machine.IRegister++;
+            }
+            traceOpcode(machine, currentOpcode, "Reading registers V0 through Vx from memory location at I");
+            break;
+        }
+        default:        // Invalid opcode
+        {
+            traceOpcode(machine, currentOpcode, "Unknown opcode");
+            break;
+        }
+        }
+        break;
+    }
+    default:            // Invalid opcode
+    {
+        traceOpcode(machine, currentOpcode, "Unknown opcode");
+        break;
+    }
+    }
+
+    if (machine.traceEnabled)
+    {
+        std::cout << "\n";
+    }
+}
+
+void tickTimers(Machine &machine)
+{
+    if (machine.delayTimer != 0)
+    {
+        machine.delayTimer -= 1;
+    }
+    if (machine.soundTimer != 0)
+    {
+        machine.soundTimer -= 1;
+    }
+}
+
+// Runs one 1/CLOCK_RATE frame: ticks the timers, then executes up to EXECUTIONS_PER_FRAME + 1 instructions.
+void executeFrame(Machine &machine)
+{
+    tickTimers(machine);
+
+    for (int i{ 0 }; machine.currentInstruction < CART_MEMORY_END && i <= EXECUTIONS_PER_FRAME; i++)
+    {
+        executeInstruction(machine);
+        if (machine.waitingForKey)
+        {
+            break;
+        }
+    }
+}
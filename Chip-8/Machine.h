@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+const int DISPLAY_WIDTH = 64;
+const int DISPLAY_HEIGHT = 32;
+
+const int CLOCK_RATE = 60;      // stores clock rate in hz (frames per second)
+
+const int MEMORY_SIZE = 0x1000;
+const int CART_MEMORY_START = 0x200;
+const int CART_MEMORY_END = 0xFFF;
+const int NUMBER_OF_KEYS = 16;
+const int STACK_DEPTH = 16;
+const int EXECUTIONS_PER_FRAME = 8;
+const int OPCODE_LENGTH_IN_BYTES = 2;
+
+// Complete state of one CHIP-8 machine. Everything lives inline (no heap members) so a machine can be
+// copied, snapshotted or handed across threads with a plain assignment.
+struct Machine
+{
+    uint8_t memory[MEMORY_SIZE];
+    uint8_t VRegister[16];
+    uint16_t IRegister;
+    uint16_t currentInstruction;
+    uint16_t stack[STACK_DEPTH];
+    uint8_t stackPointer;
+    uint8_t delayTimer;
+    uint8_t soundTimer;
+
+    // Each row of the display is packed into 64 bits, with the leftmost pixel in the most significant bit.
+    uint64_t screenRows[DISPLAY_HEIGHT];
+    bool screenDirty;           // set whenever CLS or DRW touches the display, cleared by whoever presents it
+
+    // Running XOR hashes of memory and the display, updated on every write (FX33, FX55, CLS, DRW) so
+    // machineStateHash never has to rescan them
+    uint64_t memoryHash;
+    uint64_t screenHash;
+
+    bool keyPresses[NUMBER_OF_KEYS];
+    bool waitingForKey;         // FX0A is blocking; the frame ends early until a key is down
+
+    uint32_t rngState;
+    bool traceEnabled;          // prints every executed instruction to std::cout
+};
+
+void resetMachine(Machine &machine, uint32_t seed);
+int loadRom(Machine &machine, std::string fileName);
+void loadRomData(Machine &machine, const uint8_t* data, int size);
+
+void tickTimers(Machine &machine);
+void executeInstruction(Machine &machine);
+void executeFrame(Machine &machine);
+
+// 64-bit hash of everything that determines how the machine runs from here, apart from the keys held
+uint64_t machineStateHash(const Machine &machine);
+uint64_t mixHash(uint64_t x);
+
+bool isPixelSet(const Machine &machine, int x, int y);
+void printScreenArray(const uint64_t screenRows[DISPLAY_HEIGHT]);
+void printOpcode(int opcode, std::string text = "Unknown opcode");
@@ -0,0 +1,365 @@
+#include "Scaler.h"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SCALER_USE_SSE2
+#endif
+
+// Widest intermediate bitmap is Scale4x's second pass input, 128 pixels
+const int MAX_ROW_WORDS = 4;
+
+// Slack at the end of the row buffers so the vector fill may overshoot the last pixel
+const int ROW_SLACK_PIXELS = 4;
+
+static const char* const FILTER_NAMES[NUMBER_OF_FILTERS]{ "nearest", "scale2x", "scale3x", "scale4x", "scanlines" };
+
+const char* scaleFilterName(ScaleFilter filter)
+{
+    return FILTER_NAMES[filter];
+}
+
+bool parseScaleFilter(std::string name, ScaleFilter &filter)
+{
+    for (int i{ 0 }; i < NUMBER_OF_FILTERS; i++)
+    {
+        if (name == FILTER_NAMES[i])
+        {
+            filter = static_cast<ScaleFilter>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+static int filterScale(ScaleFilter filter)
+{
+    switch (filter)
+    {
+    case FILTER_SCALE2X: return 2;
+    case FILTER_SCALE3X: return 3;
+    case FILTER_SCALE4X: return 4;
+    default: return 1;
+    }
+}
+
+void scaledOutputSize(ScaleFilter filter, int maxWidth, int maxHeight, int &width, int &height)
+{
+    int filteredWidth{ DISPLAY_WIDTH * filterScale(filter) };
+    int filteredHeight{ DISPLAY_HEIGHT * filterScale(filter) };
+    int factor{ std::max(1, std::min(maxWidth / filteredWidth, maxHeight / filteredHeight)) };
+    width = filteredWidth * factor;
+    height = filteredHeight * factor;
+}
+
+// Bitwise helpers: every bit is one pixel, so each operation evaluates an EPX rule for 64 pixels at once
+static inline uint64_t select(uint64_t mask, uint64_t a, uint64_t b)
+{
+    return (mask & a) | (~mask & b);
+}
+
+static inline uint64_t equal(uint64_t a, uint64_t b)
+{
+    return ~(a ^ b);
+}
+
+static inline uint64_t notEqual(uint64_t a, uint64_t b)
+{
+    return a ^ b;
+}
+
+// Left and right neighbours of every pixel in a row, with the edge pixels standing in for themselves
+static void neighbourRows(const uint64_t* row, int words, uint64_t* left, uint64_t* right)
+{
+    for (int i{ 0 }; i < words; i++)
+    {
+        uint64_t previous{ (i > 0) ? row[i - 1] : (row[0] >> 63) };
+        uint64_t next{ (i + 1 < words) ? row[i + 1] : (row[words - 1] << 63) };
+        left[i] = (row[i] >> 1) | (previous << 63);
+        right[i] = (row[i] << 1) | (next >> 63);
+    }
+}
+
+// Spreads 32 bits out to the even bit positions of a 64-bit word
+static inline uint64_t spreadBits(uint64_t x)
+{
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+// Writes pixels a0 b0 a1 b1 ... into two words
+static inline void interleave2(uint64_t a, uint64_t b, uint64_t* out)
+{
+    out[0] = (spreadBits(a >> 32) << 1) | spreadBits(b >> 32);
+    out[1] = (spreadBits(a & 0xFFFFFFFF) << 1) | spreadBits(b & 0xFFFFFFFF);
+}
+
+struct Spread3Table
+{
+    uint32_t entries[256];
+
+    Spread3Table()
+    {
+        for (int value{ 0 }; value < 256; value++)
+        {
+            uint32_t spread{ 0 };
+            for (int bit{ 0 }; bit < 8; bit++)
+            {
+                spread |= static_cast<uint32_t>((value >> bit) & 1) << (bit * 3);
+            }
+            entries[value] = spread;
+        }
+    }
+};
+
+static const Spread3Table SPREAD3{};
+
+// Writes pixels a0 b0 c0 a1 b1 c1 ... into three words
+static inline void interleave3(uint64_t a, uint64_t b, uint64_t c, uint64_t* out)
+{
+    uint8_t bytes[24];
+    for (int k{ 0 }; k < 8; k++)
+    {
+        int shift{ 56 - (k * 8) };
+        uint32_t spread{ (SPREAD3.entries[(a >> shift) & 0xFF] << 2) | (SPREAD3.entries[(b >> shift) & 0xFF] << 1) | SPREAD3.entries[(c >> shift) & 0xFF] };
+        bytes[(k * 3)] = static_cast<uint8_t>(spread >> 16);
+        bytes[(k * 3) + 1] = static_cast<uint8_t>(spread >> 8);
+        bytes[(k * 3) + 2] = static_cast<uint8_t>(spread);
+    }
+
+    for (int word{ 0 }; word < 3; word++)
+    {
+        uint64_t value{ 0 };
+        for (int n{ 0 }; n < 8; n++)
+        {
+            value = (value << 8) | bytes[(word * 8) + n];
+        }
+        out[word] = value;
+    }
+}
+
+// Scale2x (EPX): out is (2 * words) words wide and (2 * height) rows tall
+static void scale2x(const uint64_t* in, int words, int height, uint64_t* out)
+{
+    uint64_t left[MAX_ROW_WORDS];
+    uint64_t right[MAX_ROW_WORDS];
+
+    for (int y{ 0 }; y < height; y++)
+    {
+        const uint64_t* up{ in + (std::max(y - 1, 0) * words) };
+        const uint64_t* row{ in + (y * words) };
+        const uint64_t* down{ in + (std::min(y + 1, height - 1) * words) };
+        uint64_t* outTop{ out + ((2 * y) * (2 * words)) };
+        uint64_t* outBottom{ outTop + (2 * words) };
+
+        neighbourRows(row, words, left, right);
+
+        for (int i{ 0 }; i < words; i++)
+        {
+            uint64_t P{ row[i] };
+            uint64_t A{ up[i] };
+            uint64_t B{ right[i] };
+            uint64_t C{ left[i] };
+            uint64_t D{ down[i] };
+
+            uint64_t e0{ select(equal(C, A) & notEqual(C, D) & notEqual(A, B), A, P) };
+            uint64_t e1{ select(equal(A, B) & notEqual(A, C) & notEqual(B, D), B, P) };
+            uint64_t e2{ select(equal(D, C) & notEqual(D, B) & notEqual(C, A), C, P) };
+            uint64_t e3{ select(equal(B, D) & notEqual(B, A) & notEqual(D, C), D, P) };
+
+            interleave2(e0, e1, outTop + (2 * i));
+            interleave2(e2, e3, outBottom + (2 * i));
+        }
+    }
+}
+
+// Scale3x (AdvMAME3x): out is (3 * words) words wide and (3 * height) rows tall
+static void scale3x(const uint64_t* in, int words, int height, uint64_t* out)
+{
+    uint64_t upLeft[MAX_ROW_WORDS], upRight[MAX_ROW_WORDS];
+    uint64_t left[MAX_ROW_WORDS], right[MAX_ROW_WORDS];
+    uint64_t downLeft[MAX_ROW_WORDS], downRight[MAX_ROW_WORDS];
+
+    for (int y{ 0 }; y < height; y++)
+    {
+        const uint64_t* up{ in + (std::max(y - 1, 0) * words) };
+        const uint64_t* row{ in + (y * words) };
+        const uint64_t* down{ in + (std::min(y + 1, height - 1) * words) };
+        uint64_t* out0{ out + ((3 * y) * (3 * words)) };
+        uint64_t* out1{ out0 + (3 * words) };
+        uint64_t* out2{ out1 + (3 * words) };
+
+        neighbourRows(up, words, upLeft, upRight);
+        neighbourRows(row, words, left, right);
+        neighbourRows(down, words, downLeft, downRight);
+
+        for (int i{ 0 }; i < words; i++)
+        {
+            uint64_t A{ upLeft[i] }, B{ up[i] }, C{ upRight[i] };
+            uint64_t D{ left[i] }, E{ row[i] }, F{ right[i] };
+            uint64_t G{ downLeft[i] }, H{ down[i] }, I{ downRight[i] };
+
+            uint64_t active{ notEqual(B, H) & notEqual(D, F) };
+            uint64_t DB{ active & equal(D, B) };
+            uint64_t BF{ active & equal(B, F) };
+            uint64_t DH{ active & equal(D, H) };
+            uint64_t HF{ active & equal(H, F) };
+
+            uint64_t e0{ select(DB, D, E) };
+            uint64_t e1{ select((DB & notEqual(E, C)) | (BF & notEqual(E, A)), B, E) };
+            uint64_t e2{ select(BF, F, E) };
+            uint64_t e3{ select((DB & notEqual(E, G)) | (DH & notEqual(E, A)), D, E) };
+            uint64_t e5{ select((BF & notEqual(E, I)) | (HF & notEqual(E, C)), F, E) };
+            uint64_t e6{ select(DH, D, E) };
+            uint64_t e7{ select((DH & notEqual(E, I)) | (HF & notEqual(E, G)), H, E) };
+            uint64_t e8{ select(HF, F, E) };
+
+            interleave3(e0, e1, e2, out0 + (3 * i));
+            interleave3(e3, E, e5, out1 + (3 * i));
+            interleave3(e6, e7, e8, out2 + (3 * i));
+        }
+    }
+}
+
+static inline void fillPixels(uint32_t* destination, int count, uint32_t color)
+{
+#ifdef SCALER_USE_SSE2
+    // may run up to 3 pixels past count; callers leave ROW_SLACK_PIXELS of room or overwrite it afterwards
+    __m128i colors{ _mm_set1_epi32(static_cast<int>(color)) };
+    for (int k{ 0 }; k < count; k += 4)
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + k), colors);
+    }
+#else
+    std::fill_n(destination, count, color);
+#endif
+}
+
+static inline uint32_t dimColor(uint32_t color)
+{
+    return (color & 0xFF000000) | ((color >> 1) & 0x007F7F7F);
+}
+
+// Nearest-neighbour upscale of a 1-bit bitmap to ARGB by the largest integer factor that fits
+static void expandToPixels(Scaler &scaler, const uint64_t* bits, int words, int height, uint32_t* pixels, int pitch, int outputWidth, int outputHeight)
+{
+    const int width{ words * 64 };
+    const int factor{ std::max(1, std::min(outputWidth / width, outputHeight / height)) };
+    const int drawnWidth{ std::min(width * factor, outputWidth) };
+    const bool scanlines{ scaler.filter == FILTER_SCANLINES && factor > 1 };
+
+    scaler.rowPixels.resize((width * factor) + ROW_SLACK_PIXELS);
+    scaler.dimRowPixels.resize((width * factor) + ROW_SLACK_PIXELS);
+    const uint32_t dimOn{ dimColor(scaler.onColor) };
+    const uint32_t dimOff{ dimColor(scaler.offColor) };
+
+    int outputY{ 0 };
+    for (int y{ 0 }; y < height && outputY < outputHeight; y++)
+    {
+        const uint64_t* row{ bits + (y * words) };
+        for (int x{ 0 }; x < width; x++)
+        {
+            bool lit{ ((row[x / 64] >> (63 - (x % 64))) & 1) != 0 };
+            fillPixels(scaler.rowPixels.data() + (x * factor), factor, lit ? scaler.onColor : scaler.offColor);
+            if (scanlines)
+            {
+                fillPixels(scaler.dimRowPixels.data() + (x * factor), factor, lit ? dimOn : dimOff);
+            }
+        }
+
+        for (int k{ 0 }; k < factor && outputY < outputHeight; k++, outputY++)
+        {
+            uint32_t* destination{ reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(pixels) + (outputY * pitch)) };
+            const uint32_t* source{ (scanlines && (k & 1)) ? scaler.dimRowPixels.data() : scaler.rowPixels.data() };
+            std::memcpy(destination, source, drawnWidth * sizeof(uint32_t));
+            std::fill(destination + drawnWidth, destination + outputWidth, scaler.offColor);
+        }
+    }
+
+    for (; outputY < outputHeight; outputY++)
+    {
+        uint32_t* destination{ reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(pixels) + (outputY * pitch)) };
+        std::fill(destination, destination + outputWidth, scaler.offColor);
+    }
+}
+
+void scaleScreen(Scaler &scaler, const uint64_t screenRows[DISPLAY_HEIGHT], uint32_t* pixels, int pitch, int outputWidth, int outputHeight)
+{
+    switch (scaler.filter)
+    {
+    case FILTER_SCALE2X:
+    {
+        scaler.bits.resize(2 * (DISPLAY_HEIGHT * 2));
+        scale2x(screenRows, 1, DISPLAY_HEIGHT, scaler.bits.data());
+        expandToPixels(scaler, scaler.bits.data(), 2, DISPLAY_HEIGHT * 2, pixels, pitch, outputWidth, outputHeight);
+        break;
+    }
+    case FILTER_SCALE3X:
+    {
+        scaler.bits.resize(3 * (DISPLAY_HEIGHT * 3));
+        scale3x(screenRows, 1, DISPLAY_HEIGHT, scaler.bits.data());
+        expandToPixels(scaler, scaler.bits.data(), 3, DISPLAY_HEIGHT * 3, pixels, pitch, outputWidth, outputHeight);
+        break;
+    }
+    case FILTER_SCALE4X:
+    {
+        scaler.scratch.resize(2 * (DISPLAY_HEIGHT * 2));
+        scaler.bits.resize(4 * (DISPLAY_HEIGHT * 4));
+        scale2x(screenRows, 1, DISPLAY_HEIGHT, scaler.scratch.data());
+        scale2x(scaler.scratch.data(), 2, DISPLAY_HEIGHT * 2, scaler.bits.data());
+        expandToPixels(scaler, scaler.bits.data(), 4, DISPLAY_HEIGHT * 4, pixels, pitch, outputWidth, outputHeight);
+        break;
+    }
+    default:
+    {
+        expandToPixels(scaler, screenRows, 1, DISPLAY_HEIGHT, pixels, pitch, outputWidth, outputHeight);
+        break;
+    }
+    }
+}
+
+int runScalerBenchmark(int outputWidth, int outputHeight)
+{
+    const int ITERATIONS{ 120 };
+    const double FRAME_BUDGET_MILLISECONDS{ 1000.0 / CLOCK_RATE };
+
+    // a noisy display gives the filters the most edges to work on
+    uint64_t screenRows[DISPLAY_HEIGHT];
+    std::mt19937_64 rng{ 1234 };
+    for (uint64_t &row : screenRows)
+    {
+        row = rng() & rng();
+    }
+
+    std::vector<uint32_t> pixels(static_cast<size_t>(outputWidth) * outputHeight);
+    Scaler scaler{};
+
+    std::cout << std::dec << "Scaling to " << outputWidth << "x" << outputHeight << " on one core:\n";
+    for (int filter{ 0 }; filter < NUMBER_OF_FILTERS; filter++)
+    {
+        scaler.filter = static_cast<ScaleFilter>(filter);
+        scaleScreen(scaler, screenRows, pixels.data(), outputWidth * sizeof(uint32_t), outputWidth, outputHeight);
+
+        auto start{ std::chrono::steady_clock::now() };
+        for (int i{ 0 }; i < ITERATIONS; i++)
+        {
+            screenRows[i % DISPLAY_HEIGHT] ^= 1;
+            scaleScreen(scaler, screenRows, pixels.data(), outputWidth * sizeof(uint32_t), outputWidth, outputHeight);
+        }
+        double milliseconds{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / ITERATIONS };
+
+        std::cout << "  " << scaleFilterName(scaler.filter) << ": " << milliseconds << " ms/frame ("
+            << (100.0 * milliseconds / FRAME_BUDGET_MILLISECONDS) << "% of a " << CLOCK_RATE << " Hz frame)\n";
+    }
+
+    return 0;
+}
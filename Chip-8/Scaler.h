@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+enum ScaleFilter
+{
+    FILTER_NEAREST,
+    FILTER_SCALE2X,
+    FILTER_SCALE3X,
+    FILTER_SCALE4X,
+    FILTER_SCANLINES,
+    NUMBER_OF_FILTERS,
+};
+
+// Turns the packed 1-bit display into 32-bit ARGB pixels. The pixel-art filters run on the packed rows
+// themselves, where one 64-bit operation covers 64 pixels, and only the final integer upscale touches
+// individual output pixels.
+struct Scaler
+{
+    ScaleFilter filter{ FILTER_NEAREST };
+    uint32_t onColor{ 0xFFFFFFFF };
+    uint32_t offColor{ 0xFF000000 };
+
+    // scratch bitmaps for the filter passes, reused between frames
+    std::vector<uint64_t> bits;
+    std::vector<uint64_t> scratch;
+    std::vector<uint32_t> rowPixels;
+    std::vector<uint32_t> dimRowPixels;
+};
+
+const char* scaleFilterName(ScaleFilter filter);
+bool parseScaleFilter(std::string name, ScaleFilter &filter);
+
+// Largest integer multiple of the filtered display that fits in maxWidth x maxHeight (at least 1x)
+void scaledOutputSize(ScaleFilter filter, int maxWidth, int maxHeight, int &width, int &height);
+
+// Fills outputWidth x outputHeight pixels (pitch in bytes) with the display, filtered and then scaled up by the
+// largest integer factor that fits. Any leftover border is filled with offColor.
+void scaleScreen(Scaler &scaler, const uint64_t screenRows[DISPLAY_HEIGHT], uint32_t* pixels, int pitch, int outputWidth, int outputHeight);
+
+int runScalerBenchmark(int outputWidth, int outputHeight);
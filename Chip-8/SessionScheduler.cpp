@@ -0,0 +1,297 @@
+#include "SessionScheduler.h"
+
+#include <iostream>
+#include <chrono>
+#include <thread>
+
+static void scheduleAt(SessionScheduler &scheduler, std::coroutine_handle<> handle, uint64_t tick)
+{
+    // nothing can be filed into a tick that has already been processed
+    if (tick < scheduler.currentTick)
+    {
+        tick = scheduler.currentTick;
+    }
+    scheduler.wheel[tick % WHEEL_SLOTS].push_back(WheelEntry{ handle, tick });
+}
+
+struct FrameAwaiter
+{
+    SessionScheduler &scheduler;
+    ScheduledSession &session;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) { scheduleAt(scheduler, handle, session.deadlineMicroseconds / 1000); }
+    void await_resume() const noexcept {}
+};
+
+struct KeyAwaiter
+{
+    SessionScheduler &scheduler;
+    ScheduledSession &session;
+
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>)
+    {
+        // parked outside the wheel; pressKey reschedules session.task.handle directly
+        session.waitingForKey = true;
+        session.parkedTick = scheduler.currentTick;
+    }
+    void await_resume()
+    {
+        // the timers keep counting down while FX0A blocks, so catch them up for the frames that were skipped
+        uint64_t framesParked{ ((scheduler.currentTick - session.parkedTick) * 1000) / scheduler.framePeriodMicroseconds };
+        Machine &machine{ session.machine };
+        machine.delayTimer = (machine.delayTimer > framesParked) ? static_cast<uint8_t>(machine.delayTimer - framesParked) : 0;
+        machine.soundTimer = (machine.soundTimer > framesParked) ? static_cast<uint8_t>(machine.soundTimer - framesParked) : 0;
+    }
+};
+
+static SessionTask sessionLoop(SessionScheduler &scheduler, ScheduledSession &session)
+{
+    while (session.machine.currentInstruction < CART_MEMORY_END)
+    {
+        co_await FrameAwaiter{ scheduler, session };
+
+        executeFrame(session.machine);
+        session.framesRun++;
+
+        // every press has now been seen by at least one frame, so the releases that arrived with it can land
+        for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+        {
+            if ((session.pendingReleases >> key) & 1)
+            {
+                session.machine.keyPresses[key] = false;
+            }
+        }
+        session.pressedSinceFrame = 0;
+        session.pendingReleases = 0;
+        scheduler.framesRun++;
+        session.deadlineMicroseconds += scheduler.framePeriodMicroseconds;
+
+        if (session.machine.waitingForKey)
+        {
+            co_await KeyAwaiter{ scheduler, session };
+        }
+    }
+    session.finished = true;
+}
+
+ScheduledSession* addSession(SessionScheduler &scheduler, const Machine &romImage, uint64_t startMicroseconds)
+{
+    scheduler.sessions.push_back(std::make_unique<ScheduledSession>());
+    ScheduledSession &session{ *scheduler.sessions.back() };
+    session.machine = romImage;
+    session.deadlineMicroseconds = startMicroseconds;
+    session.parkedTick = 0;
+    session.framesRun = 0;
+    session.pressedSinceFrame = 0;
+    session.pendingReleases = 0;
+    session.waitingForKey = false;
+    session.finished = false;
+
+    // runs up to the first frame boundary, where the session files itself into the wheel
+    session.task = sessionLoop(scheduler, session);
+    session.task.handle.resume();
+    return &session;
+}
+
+void removeSession(SessionScheduler &scheduler, ScheduledSession* session)
+{
+    // a running session is filed in exactly one slot, and a parked one in none
+    std::coroutine_handle<> handle{ session->task.handle };
+    for (std::vector<WheelEntry> &slot : scheduler.wheel)
+    {
+        for (size_t i{ 0 }; i < slot.size(); i++)
+        {
+            if (slot[i].handle == handle)
+            {
+                slot[i] = slot.back();
+                slot.pop_back();
+                break;
+            }
+        }
+    }
+
+    session->task.handle.destroy();
+    for (size_t i{ 0 }; i < scheduler.sessions.size(); i++)
+    {
+        if (scheduler.sessions[i].get() == session)
+        {
+            scheduler.sessions[i] = std::move(scheduler.sessions.back());
+            scheduler.sessions.pop_back();
+            break;
+        }
+    }
+}
+
+void pressKey(SessionScheduler &scheduler, ScheduledSession &session, int key, bool pressed)
+{
+    key &= 0xF;
+    uint16_t bit{ static_cast<uint16_t>(1 << key) };
+
+    // a press and release that both arrive between two frames must still be seen by FX0A, SKP and SKNP,
+    // so the release is deferred until a frame has run with the key down
+    if (pressed)
+    {
+        session.machine.keyPresses[key] = true;
+        session.pressedSinceFrame |= bit;
+        session.pendingReleases &= ~bit;
+    }
+    else if ((session.pressedSinceFrame & bit) != 0)
+    {
+        session.pendingReleases |= bit;
+    }
+    else
+    {
+        session.machine.keyPresses[key] = false;
+    }
+
+    if (pressed && session.waitingForKey)
+    {
+        session.waitingForKey = false;
+        session.deadlineMicroseconds = scheduler.currentTick * 1000;
+        scheduleAt(scheduler, session.task.handle, scheduler.currentTick);
+    }
+}
+
+uint64_t advanceScheduler(SessionScheduler &scheduler, uint64_t tick)
+{
+    uint64_t framesBefore{ scheduler.framesRun };
+
+    while (scheduler.currentTick <= tick)
+    {
+        // currentTick always names the first unprocessed tick, so anything filed while resuming lands in the future
+        uint64_t now{ scheduler.currentTick++ };
+        std::vector<WheelEntry> &slot{ scheduler.wheel[now % WHEEL_SLOTS] };
+        if (slot.empty())
+        {
+            continue;
+        }
+
+        // resumed sessions file themselves into later slots, so the slot is drained into a scratch list first
+        scheduler.dueEntries.swap(slot);
+        for (const WheelEntry &entry : scheduler.dueEntries)
+        {
+            if (entry.tick > now)
+            {
+                slot.push_back(entry);      // due on a later revolution of the wheel
+            }
+            else
+            {
+                entry.handle.resume();
+            }
+        }
+        scheduler.dueEntries.clear();
+    }
+
+    return scheduler.framesRun - framesBefore;
+}
+
+uint64_t nextDueTick(const SessionScheduler &scheduler)
+{
+    for (uint64_t tick{ scheduler.currentTick }; tick < scheduler.currentTick + WHEEL_SLOTS; tick++)
+    {
+        if (!scheduler.wheel[tick % WHEEL_SLOTS].empty())
+        {
+            return tick;
+        }
+    }
+    return scheduler.currentTick + WHEEL_SLOTS;
+}
+
+void runScheduler(SessionScheduler &scheduler, uint64_t durationMilliseconds)
+{
+    auto start{ std::chrono::steady_clock::now() };
+    uint64_t firstTick{ scheduler.currentTick };
+
+    for (uint64_t elapsed{ 0 }; elapsed < durationMilliseconds; elapsed++)
+    {
+        advanceScheduler(scheduler, firstTick + elapsed);
+        std::this_thread::sleep_until(start + std::chrono::milliseconds(elapsed + 1));
+    }
+}
+
+void destroyScheduler(SessionScheduler &scheduler)
+{
+    for (std::unique_ptr<ScheduledSession> &session : scheduler.sessions)
+    {
+        session->task.handle.destroy();
+    }
+    scheduler.sessions.clear();
+    for (std::vector<WheelEntry> &slot : scheduler.wheel)
+    {
+        slot.clear();
+    }
+}
+
+int runSchedulerBenchmark(std::string romName, int sessionCount, int seconds)
+{
+    Machine romImage{};
+    resetMachine(romImage, 0);
+    if (loadRom(romImage, romName) == -1)
+    {
+        std::cout << "ERROR: could not load game cart\n";
+        return 0;
+    }
+
+    if (sessionCount < 1 || seconds < 1)
+    {
+        std::cout << "ERROR: sessions and seconds must be at least 1\n";
+        return 0;
+    }
+
+    const uint64_t durationTicks{ static_cast<uint64_t>(seconds) * 1000 };
+
+    // scheduled: sessions are staggered across the frame period so each tick resumes a slice of them,
+    // and simulated time is advanced as fast as possible instead of sleeping
+    SessionScheduler* scheduler{ new SessionScheduler{} };
+    for (int i{ 0 }; i < sessionCount; i++)
+    {
+        Machine seeded{ romImage };
+        seeded.rngState = static_cast<uint32_t>(i) * 2654435761u + 1;
+        addSession(*scheduler, seeded, (scheduler->framePeriodMicroseconds * i) / sessionCount);
+    }
+
+    auto start{ std::chrono::steady_clock::now() };
+    uint64_t scheduledFrames{ advanceScheduler(*scheduler, durationTicks - 1) };
+    double scheduledNanoseconds{ std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() };
+    destroyScheduler(*scheduler);
+    delete scheduler;
+
+    // a ROM that blocks on FX0A straight away parks every session, and almost no frames run at all
+    if (scheduledFrames < static_cast<uint64_t>(sessionCount))
+    {
+        std::cout << "ERROR: the sessions ran fewer frames than there are sessions, nothing to compare\n";
+        return 0;
+    }
+
+    // baseline: the same number of frames stepped in a plain loop with no scheduling at all
+    std::vector<Machine> machines(sessionCount, romImage);
+    for (int i{ 0 }; i < sessionCount; i++)
+    {
+        machines[i].rngState = static_cast<uint32_t>(i) * 2654435761u + 1;
+    }
+    uint64_t framesPerMachine{ scheduledFrames / sessionCount };
+
+    start = std::chrono::steady_clock::now();
+    for (uint64_t frame{ 0 }; frame < framesPerMachine; frame++)
+    {
+        for (Machine &machine : machines)
+        {
+            executeFrame(machine);
+        }
+    }
+    double baselineNanoseconds{ std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() };
+    uint64_t baselineFrames{ framesPerMachine * sessionCount };
+
+    double scheduledPerFrame{ scheduledNanoseconds / scheduledFrames };
+    double baselinePerFrame{ baselineNanoseconds / baselineFrames };
+
+    std::cout << std::dec << sessionCount << " sessions, " << seconds << " s simulated, " << scheduledFrames << " frames\n"
+        << "scheduled:  " << scheduledPerFrame << " ns/frame\n"
+        << "plain loop: " << baselinePerFrame << " ns/frame\n"
+        << "scheduling overhead: " << (scheduledPerFrame - baselinePerFrame) << " ns/frame\n"
+        << "paced sessions per core at " << CLOCK_RATE << " Hz: " << static_cast<uint64_t>(1e9 / (scheduledPerFrame * CLOCK_RATE)) << "\n";
+
+    return 0;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <coroutine>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// One wheel slot per millisecond; a frame is ~16.7 ms, so a paced session never waits more than one revolution
+const int WHEEL_SLOTS = 1024;
+
+struct SessionTask
+{
+    struct promise_type
+    {
+        SessionTask get_return_object() { return SessionTask{ std::coroutine_handle<promise_type>::from_promise(*this) }; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { throw; }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+struct ScheduledSession
+{
+    Machine machine;
+    SessionTask task;
+    uint64_t deadlineMicroseconds;      // when the next frame is due, in scheduler time
+    uint64_t parkedTick;                // tick the session started waiting on FX0A
+    uint64_t framesRun;
+    uint16_t pressedSinceFrame;         // keys pressed since the last frame ran, one bit per key
+    uint16_t pendingReleases;           // releases held back until the frame that sees the press has run
+    bool waitingForKey;
+    bool finished;
+};
+
+struct WheelEntry
+{
+    std::coroutine_handle<> handle;
+    uint64_t tick;
+};
+
+// Runs every session as a coroutine on the calling thread. A session suspends after each frame and is filed
+// into the timer wheel slot for its next deadline; a session blocked on FX0A is parked outside the wheel
+// entirely until pressKey wakes it. Each tick only touches the sessions that are due.
+struct SessionScheduler
+{
+    std::vector<WheelEntry> wheel[WHEEL_SLOTS];
+    std::vector<WheelEntry> dueEntries;
+    std::vector<std::unique_ptr<ScheduledSession>> sessions;
+    uint64_t currentTick{ 0 };          // first unprocessed millisecond of scheduler time
+    uint64_t framePeriodMicroseconds{ 1000000 / CLOCK_RATE };
+    uint64_t framesRun{ 0 };
+};
+
+ScheduledSession* addSession(SessionScheduler &scheduler, const Machine &romImage, uint64_t startMicroseconds);
+void removeSession(SessionScheduler &scheduler, ScheduledSession* session);
+void pressKey(SessionScheduler &scheduler, ScheduledSession &session, int key, bool pressed);
+
+// Resumes every session due up to and including tick. Returns the number of frames that were run.
+uint64_t advanceScheduler(SessionScheduler &scheduler, uint64_t tick);
+
+// Earliest tick with anything filed in the wheel, or currentTick + WHEEL_SLOTS when nothing is
+uint64_t nextDueTick(const SessionScheduler &scheduler);
+
+// Runs in real time, sleeping between ticks, for the given number of milliseconds
+void runScheduler(SessionScheduler &scheduler, uint64_t durationMilliseconds);
+void destroyScheduler(SessionScheduler &scheduler);
+
+int runSchedulerBenchmark(std::string romName, int sessionCount, int seconds);
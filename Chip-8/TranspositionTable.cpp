@@ -0,0 +1,234 @@
+#include "TranspositionTable.h"
+
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+void initTranspositionTable(TranspositionTable &table, uint64_t entryCount)
+{
+    uint64_t size{ 1 };
+    while ((size * 2) <= entryCount)
+    {
+        size *= 2;
+    }
+    table.entries = std::make_unique<TranspositionEntry[]>(size);
+    table.mask = size - 1;
+}
+
+static inline TranspositionEntry& entryFor(TranspositionTable &table, uint64_t stateHash, uint32_t input)
+{
+    return table.entries[(stateHash ^ mixHash(input)) & table.mask];
+}
+
+bool probeTransposition(TranspositionTable &table, uint64_t stateHash, uint32_t input, Machine &result)
+{
+    TranspositionEntry &entry{ entryFor(table, stateHash, input) };
+
+    uint64_t before{ entry.sequence.load(std::memory_order_acquire) };
+    if ((before & 1) != 0
+        || entry.stateHash.load(std::memory_order_relaxed) != stateHash
+        || entry.input.load(std::memory_order_relaxed) != input)
+    {
+        return false;
+    }
+
+    // copied aside first: a writer that slips in during the copy bumps the sequence, and the torn copy must
+    // never reach the caller
+    Machine snapshot;
+    std::memcpy(&snapshot, &entry.result, sizeof(Machine));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (entry.sequence.load(std::memory_order_relaxed) != before)
+    {
+        return false;
+    }
+    std::memcpy(&result, &snapshot, sizeof(Machine));
+    return true;
+}
+
+void storeTransposition(TranspositionTable &table, uint64_t stateHash, uint32_t input, const Machine &result)
+{
+    TranspositionEntry &entry{ entryFor(table, stateHash, input) };
+
+    // claim the slot by making its sequence odd; if another writer has it, this result is not worth waiting for
+    uint64_t sequence{ entry.sequence.load(std::memory_order_relaxed) };
+    if ((sequence & 1) != 0 || !entry.sequence.compare_exchange_strong(sequence, sequence + 1, std::memory_order_relaxed))
+    {
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    entry.stateHash.store(stateHash, std::memory_order_relaxed);
+    entry.input.store(input, std::memory_order_relaxed);
+    std::memcpy(&entry.result, &result, sizeof(Machine));
+
+    entry.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool stepCached(TranspositionTable &table, Machine &machine, uint16_t keyMask, int frames)
+{
+    // the held keys are not part of machineStateHash, so they and the frame count make up the input
+    uint64_t stateHash{ machineStateHash(machine) };
+    uint32_t input{ static_cast<uint32_t>(keyMask) | (static_cast<uint32_t>(frames) << 16) };
+
+    if (probeTransposition(table, stateHash, input, machine))
+    {
+        return true;
+    }
+
+    for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+    {
+        machine.keyPresses[key] = ((keyMask >> key) & 1) != 0;
+    }
+    for (int frame{ 0 }; frame < frames; frame++)
+    {
+        executeFrame(machine);
+    }
+
+    storeTransposition(table, stateHash, input, machine);
+    return false;
+}
+
+// The inputs the sample search branches on: nothing held, or one of the keys most games steer with
+static const uint16_t SEARCH_INPUTS[]{ 0x0000, 1 << 0x4, 1 << 0x5, 1 << 0x6 };
+static const int SEARCH_BRANCHES{ sizeof(SEARCH_INPUTS) / sizeof(SEARCH_INPUTS[0]) };
+
+struct SearchCounters
+{
+    uint64_t nodes{ 0 };
+    uint64_t hits{ 0 };
+    uint64_t leafHashSum{ 0 };
+};
+
+static void searchPlain(const Machine &machine, int depth, int framesPerStep, SearchCounters &counters)
+{
+    if (depth == 0)
+    {
+        counters.leafHashSum += machineStateHash(machine);
+        return;
+    }
+    for (uint16_t keyMask : SEARCH_INPUTS)
+    {
+        Machine child{ machine };
+        for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+        {
+            child.keyPresses[key] = ((keyMask >> key) & 1) != 0;
+        }
+        for (int frame{ 0 }; frame < framesPerStep; frame++)
+        {
+            executeFrame(child);
+        }
+        counters.nodes++;
+        searchPlain(child, depth - 1, framesPerStep, counters);
+    }
+}
+
+static void searchCached(TranspositionTable &table, const Machine &machine, int depth, int framesPerStep, SearchCounters &counters)
+{
+    if (depth == 0)
+    {
+        counters.leafHashSum += machineStateHash(machine);
+        return;
+    }
+    for (uint16_t keyMask : SEARCH_INPUTS)
+    {
+        Machine child{ machine };
+        if (stepCached(table, child, keyMask, framesPerStep))
+        {
+            counters.hits++;
+        }
+        counters.nodes++;
+        searchCached(table, child, depth - 1, framesPerStep, counters);
+    }
+}
+
+// Iterative deepening, as a game-tree search would run it: every pass re-walks the tree of the pass before.
+// The first level is split across one thread per branch, all sharing the one table.
+static double runSearch(TranspositionTable* table, const Machine &root, int depth, int framesPerStep, SearchCounters &total)
+{
+    auto start{ std::chrono::steady_clock::now() };
+
+    for (int pass{ 1 }; pass <= depth; pass++)
+    {
+        SearchCounters counters[SEARCH_BRANCHES]{};
+        std::vector<std::thread> threads;
+        for (int branch{ 0 }; branch < SEARCH_BRANCHES; branch++)
+        {
+            threads.emplace_back([&, branch]()
+            {
+                Machine child{ root };
+                if (table != nullptr)
+                {
+                    counters[branch].hits += stepCached(*table, child, SEARCH_INPUTS[branch], framesPerStep) ? 1 : 0;
+                    counters[branch].nodes++;
+                    searchCached(*table, child, pass - 1, framesPerStep, counters[branch]);
+                }
+                else
+                {
+                    for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+                    {
+                        child.keyPresses[key] = ((SEARCH_INPUTS[branch] >> key) & 1) != 0;
+                    }
+                    for (int frame{ 0 }; frame < framesPerStep; frame++)
+                    {
+                        executeFrame(child);
+                    }
+                    counters[branch].nodes++;
+                    searchPlain(child, pass - 1, framesPerStep, counters[branch]);
+                }
+            });
+        }
+        for (std::thread &thread : threads)
+        {
+            thread.join();
+        }
+        for (const SearchCounters &counter : counters)
+        {
+            total.nodes += counter.nodes;
+            total.hits += counter.hits;
+            total.leafHashSum += counter.leafHashSum;
+        }
+    }
+
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int runSearchBenchmark(std::string romName, int depth, int framesPerStep)
+{
+    Machine root{};
+    resetMachine(root, 0);
+    if (loadRom(root, romName) == -1)
+    {
+        std::cout << "ERROR: could not load game cart\n";
+        return 0;
+    }
+    if (depth < 1 || framesPerStep < 1)
+    {
+        std::cout << "ERROR: depth and frames per step must be at least 1\n";
+        return 0;
+    }
+
+    SearchCounters plain{};
+    double plainMilliseconds{ runSearch(nullptr, root, depth, framesPerStep, plain) };
+
+    TranspositionTable* table{ new TranspositionTable{} };
+    initTranspositionTable(*table, 1 << 14);
+    SearchCounters cached{};
+    double cachedMilliseconds{ runSearch(table, root, depth, framesPerStep, cached) };
+    delete table;
+
+    std::cout << std::dec << "iterative deepening to depth " << depth << ", " << SEARCH_BRANCHES << " inputs, "
+        << framesPerStep << " frames per step, " << plain.nodes << " steps per run\n"
+        << "plain:  " << plainMilliseconds << " ms\n"
+        << "cached: " << cachedMilliseconds << " ms, " << cached.hits << " hits ("
+        << (100.0 * cached.hits / cached.nodes) << "% hit rate)\n"
+        << "speedup: " << (plainMilliseconds / cachedMilliseconds) << "x\n";
+
+    if (plain.leafHashSum != cached.leafHashSum)
+    {
+        std::cout << "ERROR: cached search reached different states than the plain search\n";
+    }
+    return 0;
+}
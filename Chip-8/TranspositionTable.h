@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Machine.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// One slot of the table. The sequence number works as a seqlock: it is odd while a writer is filling the slot,
+// and a reader only trusts a copy if the sequence was even and unchanged across it.
+struct alignas(64) TranspositionEntry
+{
+    std::atomic<uint64_t> sequence{ 0 };
+    std::atomic<uint64_t> stateHash{ 0 };
+    std::atomic<uint32_t> input{ 0 };
+    Machine result;
+};
+
+// Bounded, direct-mapped cache from (machineStateHash, input) to the machine that stepping produced. Any number
+// of threads may probe and store at once without locking: a writer that finds the slot busy simply drops its
+// result, and a reader that races a writer reports a miss.
+struct TranspositionTable
+{
+    std::unique_ptr<TranspositionEntry[]> entries;
+    uint64_t mask{ 0 };
+};
+
+// entryCount is rounded down to a power of two
+void initTranspositionTable(TranspositionTable &table, uint64_t entryCount);
+
+// Leaves result untouched unless a complete, untorn entry for exactly this state and input was found
+bool probeTransposition(TranspositionTable &table, uint64_t stateHash, uint32_t input, Machine &result);
+void storeTransposition(TranspositionTable &table, uint64_t stateHash, uint32_t input, const Machine &result);
+
+// Holds the keys in keyMask down and runs frames frames, or copies the cached outcome if this exact state has
+// already been stepped that way. Returns true on a cache hit.
+bool stepCached(TranspositionTable &table, Machine &machine, uint16_t keyMask, int frames);
+
+int runSearchBenchmark(std::string romName, int depth, int framesPerStep);
@@ -0,0 +1,183 @@
+#include "WallView.h"
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+bool initWallView(WallView &wall, std::string romName, int sessionCount, int maxWidth, int maxHeight)
+{
+    Machine romImage{};
+    resetMachine(romImage, 0);
+    if (loadRom(romImage, romName) == -1)
+    {
+        std::cout << "ERROR: could not load game cart\n";
+        return false;
+    }
+    if (sessionCount < 1)
+    {
+        std::cout << "ERROR: the wall needs at least one session\n";
+        return false;
+    }
+
+    wall.columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(sessionCount))));
+    wall.rows = (sessionCount + wall.columns - 1) / wall.columns;
+
+    int tileScale{ std::max(1, std::min(maxWidth / (wall.columns * DISPLAY_WIDTH), maxHeight / (wall.rows * DISPLAY_HEIGHT))) };
+    wall.tileWidth = DISPLAY_WIDTH * tileScale;
+    wall.tileHeight = DISPLAY_HEIGHT * tileScale;
+    wall.atlasWidth = wall.columns * wall.tileWidth;
+    wall.atlasHeight = wall.rows * wall.tileHeight;
+    wall.atlas.assign(static_cast<size_t>(wall.atlasWidth) * wall.atlasHeight, wall.scaler.offColor);
+
+    // every session gets its own random seed so the tiles do not all play out identically
+    wall.tiles.clear();
+    for (int i{ 0 }; i < sessionCount; i++)
+    {
+        Machine seeded{ romImage };
+        seeded.rngState = static_cast<uint32_t>(i) * 2654435761u + 1;
+        wall.tiles.push_back(WallTile{ addSession(wall.scheduler, seeded, 0), 0, false });
+    }
+
+    wall.focusedTile = 0;
+    wall.dirtyTop = 0;
+    wall.dirtyBottom = wall.atlasHeight;
+    return true;
+}
+
+void destroyWallView(WallView &wall)
+{
+    destroyScheduler(wall.scheduler);
+    wall.tiles.clear();
+}
+
+int updateWallTiles(WallView &wall)
+{
+    int tilesDrawn{ 0 };
+    const int pitch{ wall.atlasWidth * static_cast<int>(sizeof(uint32_t)) };
+
+    for (size_t i{ 0 }; i < wall.tiles.size(); i++)
+    {
+        WallTile &tile{ wall.tiles[i] };
+        Machine &machine{ tile.session->machine };
+        if (!machine.screenDirty && tile.drawn)
+        {
+            continue;
+        }
+        machine.screenDirty = false;
+
+        // sprites are XOR-drawn, so a frame that draws and erases the same sprite leaves the picture unchanged
+        if (tile.drawn && machine.screenHash == tile.drawnScreenHash)
+        {
+            continue;
+        }
+
+        int top{ static_cast<int>(i / wall.columns) * wall.tileHeight };
+        int left{ static_cast<int>(i % wall.columns) * wall.tileWidth };
+        scaleScreen(wall.scaler, machine.screenRows, wall.atlas.data() + (static_cast<size_t>(top) * wall.atlasWidth) + left,
+            pitch, wall.tileWidth, wall.tileHeight);
+
+        tile.drawnScreenHash = machine.screenHash;
+        tile.drawn = true;
+        tilesDrawn++;
+
+        if (wall.dirtyTop >= wall.dirtyBottom)
+        {
+            wall.dirtyTop = top;
+            wall.dirtyBottom = top + wall.tileHeight;
+        }
+        else
+        {
+            wall.dirtyTop = std::min(wall.dirtyTop, top);
+            wall.dirtyBottom = std::max(wall.dirtyBottom, top + wall.tileHeight);
+        }
+    }
+
+    return tilesDrawn;
+}
+
+int tileAt(const WallView &wall, int x, int y, int viewWidth, int viewHeight)
+{
+    if (x < 0 || y < 0 || x >= viewWidth || y >= viewHeight)
+    {
+        return -1;
+    }
+    int tile{ ((y * wall.rows) / viewHeight) * wall.columns + ((x * wall.columns) / viewWidth) };
+    return (tile < static_cast<int>(wall.tiles.size())) ? tile : -1;
+}
+
+void focusTile(WallView &wall, int tile)
+{
+    if (tile < 0 || tile >= static_cast<int>(wall.tiles.size()) || tile == wall.focusedTile)
+    {
+        return;
+    }
+
+    // keys still held on the old tile would otherwise stay down there forever
+    for (int key{ 0 }; key < NUMBER_OF_KEYS; key++)
+    {
+        if (wall.heldKeys[key])
+        {
+            pressKey(wall.scheduler, *wall.tiles[wall.focusedTile].session, key, false);
+            wall.heldKeys[key] = false;
+        }
+    }
+    wall.focusedTile = tile;
+}
+
+void pressFocusedKey(WallView &wall, int key, bool pressed)
+{
+    wall.heldKeys[key & 0xF] = pressed;
+    pressKey(wall.scheduler, *wall.tiles[wall.focusedTile].session, key, pressed);
+}
+
+int runWallBenchmark(std::string romName, int sessionCount, int seconds)
+{
+    const double FRAME_BUDGET_MILLISECONDS{ 1000.0 / CLOCK_RATE };
+
+    WallView* wall{ new WallView{} };
+    if (!initWallView(*wall, romName, sessionCount, 1920, 1080))
+    {
+        delete wall;
+        return 0;
+    }
+
+    // stands in for the texture: the dirty band is copied out once per refresh, as SDL_UpdateTexture would
+    std::vector<uint32_t> uploaded(wall->atlas.size());
+
+    const int refreshes{ seconds * CLOCK_RATE };
+    uint64_t framesRun{ 0 };
+    uint64_t tilesDrawn{ 0 };
+    double totalMilliseconds{ 0 };
+    double worstMilliseconds{ 0 };
+
+    for (int refresh{ 0 }; refresh < refreshes; refresh++)
+    {
+        auto start{ std::chrono::steady_clock::now() };
+
+        framesRun += advanceScheduler(wall->scheduler, ((static_cast<uint64_t>(refresh) + 1) * 1000) / CLOCK_RATE);
+        tilesDrawn += updateWallTiles(*wall);
+        if (wall->dirtyTop < wall->dirtyBottom)
+        {
+            size_t offset{ static_cast<size_t>(wall->dirtyTop) * wall->atlasWidth };
+            size_t count{ static_cast<size_t>(wall->dirtyBottom - wall->dirtyTop) * wall->atlasWidth };
+            std::memcpy(uploaded.data() + offset, wall->atlas.data() + offset, count * sizeof(uint32_t));
+            wall->dirtyTop = wall->dirtyBottom = 0;
+        }
+
+        double milliseconds{ std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() };
+        totalMilliseconds += milliseconds;
+        worstMilliseconds = std::max(worstMilliseconds, milliseconds);
+    }
+
+    std::cout << std::dec << sessionCount << " sessions in a " << wall->columns << "x" << wall->rows << " wall, "
+        << wall->atlasWidth << "x" << wall->atlasHeight << " atlas, " << refreshes << " refreshes\n"
+        << "frames run: " << framesRun << ", tiles redrawn per refresh: " << (static_cast<double>(tilesDrawn) / refreshes) << "\n"
+        << "per refresh: " << (totalMilliseconds / refreshes) << " ms average, " << worstMilliseconds << " ms worst, of a "
+        << FRAME_BUDGET_MILLISECONDS << " ms budget at " << CLOCK_RATE << " Hz\n";
+
+    destroyWallView(*wall);
+    delete wall;
+    return 0;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Machine.h"
+#include "Scaler.h"
+#include "SessionScheduler.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct WallTile
+{
+    ScheduledSession* session;
+    uint64_t drawnScreenHash;           // screenHash of the display currently in the atlas
+    bool drawn;
+};
+
+// Lays N sessions out as tiles of one CPU-side texture atlas. A tile is only redrawn when its machine touched the
+// display and the display hash says the picture really changed, and only the band of tile rows that was redrawn
+// needs to be uploaded. Input goes to the focused tile.
+struct WallView
+{
+    SessionScheduler scheduler;
+    std::vector<WallTile> tiles;
+    Scaler scaler;
+
+    int columns{ 0 };
+    int rows{ 0 };
+    int tileWidth{ 0 };
+    int tileHeight{ 0 };
+    int atlasWidth{ 0 };
+    int atlasHeight{ 0 };
+    std::vector<uint32_t> atlas;
+
+    // pixel rows of the atlas redrawn since the last upload; empty when dirtyTop >= dirtyBottom
+    int dirtyTop{ 0 };
+    int dirtyBottom{ 0 };
+
+    int focusedTile{ 0 };
+    bool heldKeys[NUMBER_OF_KEYS]{};
+};
+
+// Picks the largest integer tile scale that fits every tile in maxWidth x maxHeight
+bool initWallView(WallView &wall, std::string romName, int sessionCount, int maxWidth, int maxHeight);
+void destroyWallView(WallView &wall);
+
+// Redraws the tiles whose display changed into the atlas. Returns the number of tiles redrawn.
+int updateWallTiles(WallView &wall);
+
+// Tile under a point of a view that shows the whole atlas at viewWidth x viewHeight, or -1
+int tileAt(const WallView &wall, int x, int y, int viewWidth, int viewHeight);
+void focusTile(WallView &wall, int tile);
+void pressFocusedKey(WallView &wall, int key, bool pressed);
+
+int runWallBenchmark(std::string romName, int sessionCount, int seconds);